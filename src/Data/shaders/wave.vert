@@ -1,8 +1,16 @@
-uniform float wave_phase;
-uniform vec2 wave_amplitude;
+uniform vec2 texture_size;
 
 void main()
 {
+    // texCoords.x packs the wave amplitude (10 bits per axis, in 1/64th of a pixel) and the corner of the texture,
+    // texCoords.y is the wave phase
+    float packed = gl_MultiTexCoord0.x;
+    float wave_phase = gl_MultiTexCoord0.y;
+
+    vec2 corner = vec2(mod(packed, 2.0), mod(floor(packed / 2.0), 2.0));
+    float amplitude = floor(packed / 4.0);
+    vec2 wave_amplitude = vec2(mod(amplitude, 1024.0), floor(amplitude / 1024.0)) / 64.0;
+
     vec4 vertex = gl_Vertex;
     vertex.x += cos(gl_Vertex.y * 0.02 + wave_phase * 3.8) * wave_amplitude.x
               + sin(gl_Vertex.y * 0.02 + wave_phase * 6.3) * wave_amplitude.x * 0.3;
@@ -10,6 +18,6 @@ void main()
               + cos(gl_Vertex.x * 0.02 + wave_phase * 5.2) * wave_amplitude.y * 0.3;
 
 	gl_Position = gl_ModelViewProjectionMatrix * vertex;
-	gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;
+	gl_TexCoord[0] = gl_TextureMatrix[0] * vec4(corner * texture_size, 0.0, 1.0);
 	gl_FrontColor = gl_Color;
 }
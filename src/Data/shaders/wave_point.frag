@@ -0,0 +1,11 @@
+#version 150 compatibility
+
+uniform sampler2D particle_texture;
+
+in vec2 tex_coord;
+in vec4 frag_color;
+
+void main()
+{
+	gl_FragColor = frag_color * texture(particle_texture, tex_coord);
+}
@@ -0,0 +1,14 @@
+#version 150 compatibility
+
+// texCoords.x packs the wave amplitude (6 bits per axis, in 1/4th of a pixel) plus the size of the particle
+// (as a fraction of the size of the texture), texCoords.y is the wave phase
+out vec2 record;
+out vec4 color;
+
+void main()
+{
+	// the corners get displaced and projected by the geometry shader
+	gl_Position = gl_Vertex;
+	record = gl_MultiTexCoord0.xy;
+	color = gl_Color;
+}
@@ -3,7 +3,17 @@
  *
  * @date       April 23, 2015
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Clients can resume their session on reconnect.
+ *
+ *             October 18, 2026
+ *             The handlers run on the server's worker shards while holding the lock of the sender's wall.
+ *
+ *             October 18, 2026
+ *             Players can cross over to the screens of a linked peer server.
+ *
+ *             October 18, 2026
+ *             Stops on SIGINT/SIGTERM and can run as a daemon.
  *
  * @designer   Melvin Loho
  *
@@ -14,6 +24,9 @@
  */
 
 #include <map>
+#include <signal.h>
+#include <thread>
+#include <unistd.h>
 #include "net/server/Server.h"
 #include "net/Shared.h"
 #include "net/PacketCreator.h"
@@ -48,7 +61,7 @@ void reflectPacketToSendersEso(const Packet& packet, Client* sender)
 // Sync Inverse ESO
 void reflectPacketToThoseInSendersScreen(const Packet& packet, const Client* sender)
 {
-	for (Client* c : server.getClients())
+	for (Client* c : sender->room->getList())
 	{
 		if (c->screenCurrent == sender->screenOwned)
 		{
@@ -57,21 +70,152 @@ void reflectPacketToThoseInSendersScreen(const Packet& packet, const Client* sen
 	}
 }
 
+// The screen next to a peer's proxy screen, on this server's side of the link
+Screen* edgeScreenOf(const Client* peer)
+{
+	Screen* edge = peer->peer->side == CROSS_LEFT ? peer->screenOwned->next : peer->screenOwned->prev;
+
+	return (edge && !edge->owner->peer) ? edge : nullptr;
+}
+
+// Sync the peer's proxy screen with our edge screen
+void syncPeer(Client* peer)
+{
+	Screen* edge = edgeScreenOf(peer);
+
+	if (edge)
+	{
+		Server::SendToPeer(PacketCreator::Create().P_Screen(edge), peer);
+	}
+}
+
+// Sync the peers next to the sender's screen
+void syncPeersNextTo(const Client* sender)
+{
+	if (sender->screenOwned->prev && sender->screenOwned->prev->owner->peer) syncPeer(sender->screenOwned->prev->owner);
+	if (sender->screenOwned->next && sender->screenOwned->next->owner->peer) syncPeer(sender->screenOwned->next->owner);
+}
+
+// Sync the players on (or overlapping) the sender's screen, to a sender that dropped them
+void syncVisitorsOf(Client* sender)
+{
+	Screen* screen = sender->screenOwned;
+
+	for (Client* c : sender->room->getList())
+	{
+		if (c == sender || c->peer) continue;
+
+		if (c->screenCurrent == screen)
+		{
+			Server::Send(PacketCreator::Create().P_New(c->id, CROSS_RIGHT, -c->params.emitterPos.x, c->params.emitterPos.y / screen->size.y, c->params), sender);
+		}
+		else if (c->externalScreenOccupancies.find(screen) != c->externalScreenOccupancies.end())
+		{
+			// placed the way a P_MOVE crossing over from its current screen would
+			if (c->screenCurrent->prev == screen)
+			{
+				Server::Send(PacketCreator::Create().P_New(c->id, CROSS_LEFT, c->params.emitterPos.x, c->params.emitterPos.y / c->screenCurrent->size.y, c->params), sender);
+			}
+			else if (c->screenCurrent->next == screen)
+			{
+				Server::Send(PacketCreator::Create().P_New(c->id, CROSS_RIGHT, c->screenCurrent->size.x - c->params.emitterPos.x, c->params.emitterPos.y / c->screenCurrent->size.y, c->params), sender);
+			}
+		}
+	}
+}
+
 void onConnect(Client* client)
 {
-	cout << "Client " << client->id << " [" << client->socket.getRemoteAddress() << "] " << "connected!" << endl;
+	cout << (client->peer ? "Peer " : "Client ") << client->id << " [" << client->socket.getRemoteAddress() << "] " << "connected!" << endl;
+
+	// a link we made ourselves is already on its wall
+	if (client->peer && client->room)
+	{
+		syncPeer(client);
+	}
+}
+
+void onPeerReceive(const Packet& receivedPacket, Client* sender)
+{
+	switch (receivedPacket.type)
+	{
+	case P_PEER:
+	{
+		cout << "Peer " << sender->id << " linked to the " << (sender->peer->side == CROSS_LEFT ? "left" : "right") << " of wall " << sender->room->getWallID() << "!" << endl;
+
+		syncPeer(sender);
+	}
+	break;
+
+	case P_SCREEN:
+	{
+		// the proxy takes the size of the peer's edge screen
+		sender->screenOwned->size.x = receivedPacket.get<unsigned int>(0);
+		sender->screenOwned->size.y = receivedPacket.get<unsigned int>(1);
+		sender->screenOwned->boundaryLeft = sender->screenOwned->size.x * 0.125f;
+		sender->screenOwned->boundaryRight = sender->screenOwned->size.x - sender->screenOwned->boundaryLeft;
+	}
+	break;
+
+	case P_RELAY:
+	{
+		Screen* edge = edgeScreenOf(sender);
+
+		if (!edge) break;
+
+		Packet relayed;
+		relayed.type = static_cast<PacketType>(receivedPacket.get<int>(0));
+		relayed.data.assign(receivedPacket.data.begin() + 1, receivedPacket.data.end());
+
+		// the peer's entity IDs might clash with ours
+		size_t idPos = (relayed.type == P_NEW || relayed.type == P_DEL) ? 0 : relayed.last();
+		EntityID remoteID = relayed.get<EntityID>(idPos);
+		std::map<EntityID, EntityID>::iterator mapped = sender->peer->ids.find(remoteID);
+
+		if (mapped == sender->peer->ids.end())
+		{
+			if (relayed.type != P_NEW) break;
+
+			mapped = sender->peer->ids.insert(std::make_pair(remoteID, ClientManager::NewEntityID())).first;
+		}
+
+		relayed.replace(idPos, mapped->second);
+
+		if (relayed.type == P_DEL) sender->peer->ids.erase(mapped);
+
+		Server::Send(relayed, edge->owner);
+	}
+	break;
+	}
 }
 
 void onReceive(const Packet& receivedPacket, Client* sender)
 {
+	if (sender->peer)
+	{
+		onPeerReceive(receivedPacket, sender);
+		return;
+	}
+
 	switch (receivedPacket.type)
 	{
 	case P_INIT:
 	{
-		// sync params
-		sender->params.name = receivedPacket.get(0);
-		sender->params.pp.colorBegin = sf::Color(receivedPacket.get<sf::Uint32>(1));
-		sender->params.pp.colorEnd = sf::Color(receivedPacket.get<sf::Uint32>(2));
+		sf::Uint32 sessionToken = receivedPacket.getDataSize() > 5 ? receivedPacket.get<sf::Uint32>(5) : Client::NO_SESSION;
+		bool resumed = sessionToken != Client::NO_SESSION && sender->room->resume(sender, sessionToken);
+
+		if (resumed)
+		{
+			// the server's copy of the params, position, wall slot and ESOs are kept as they were
+			cout << "Client " << sender->id << " resumed its session on wall " << sender->room->getWallID() << "!" << endl;
+		}
+		else
+		{
+			// sync params
+			sender->params.name = receivedPacket.get(0);
+			sender->params.pp.colorBegin = sf::Color(receivedPacket.get<sf::Uint32>(1));
+			sender->params.pp.colorEnd = sf::Color(receivedPacket.get<sf::Uint32>(2));
+		}
 
 		// sync screen sizes/boundaries
 		sender->screenOwned->size.x = receivedPacket.get<unsigned int>(3);
@@ -79,12 +223,29 @@ void onReceive(const Packet& receivedPacket, Client* sender)
 		sender->screenOwned->boundaryLeft = sender->screenOwned->size.x * 0.25f;
 		sender->screenOwned->boundaryRight = sender->screenOwned->size.x - sender->screenOwned->boundaryLeft;
 
-		// center the emitter's position
-		sender->params.emitterPos.x = sender->screenOwned->size.x * 0.5f;
-		sender->params.emitterPos.y = sender->screenOwned->size.y * 0.5f;
+		if (!resumed)
+		{
+			// center the emitter's position
+			sender->params.emitterPos.x = sender->screenOwned->size.x * 0.5f;
+			sender->params.emitterPos.y = sender->screenOwned->size.y * 0.5f;
+		}
 
-		// send back the packet (might want to remove the contents unless they are changed)
-		reflectPacketToSender(receivedPacket, sender);
+		// send back the session's state along with its token
+		reflectPacketToSender(PacketCreator::Create().P_Init(sender->params, sender->screenOwned, sender->sessionToken, sender->room->getWallID()), sender);
+
+		if (resumed)
+		{
+			// a resumed client might still be away from home
+			if (sender->screenCurrent != sender->screenOwned)
+			{
+				reflectPacketToSender(PacketCreator::Create().P_Screen(sender->screenCurrent), sender);
+			}
+
+			// the P_INIT dropped its visitors, the P_NEWs and P_DELs it missed while detached are replaced by the current ones
+			syncVisitorsOf(sender);
+		}
+
+		syncPeersNextTo(sender);
 	}
 	break;
 
@@ -127,6 +288,8 @@ void onReceive(const Packet& receivedPacket, Client* sender)
 		Packet reflectPacket = receivedPacket;
 
 		reflectPacketToThoseInSendersScreen(reflectPacket, sender);
+
+		syncPeersNextTo(sender);
 	}
 	break;
 
@@ -240,8 +403,44 @@ void onReceive(const Packet& receivedPacket, Client* sender)
 	}
 }
 
+void onPeerDisconnect(Client* peer)
+{
+	cout << "Peer " << peer->id << " disconnected!" << endl;
+
+	// the peer's players are gone from our edge screen
+	Screen* edge = edgeScreenOf(peer);
+
+	if (edge)
+	{
+		for (std::map<EntityID, EntityID>::value_type& mapped : peer->peer->ids)
+		{
+			Server::Send(PacketCreator::Create().P_Del(mapped.second), edge->owner);
+		}
+	}
+
+	// and our players on the peer's side are sent back home
+	for (Client* c : peer->room->getList())
+	{
+		if (c->screenCurrent == peer->screenOwned)
+		{
+			c->screenCurrent = c->screenOwned;
+			c->params.emitterPos.x = c->screenOwned->size.x * 0.5f;
+			c->params.emitterPos.y = c->screenOwned->size.y * 0.5f;
+
+			Server::Send(PacketCreator::Create().P_Screen(c->screenOwned), c);
+			Server::Send(PacketCreator::Create().P_New(Client::MYSELF, CROSS_RIGHT, -c->params.emitterPos.x, 0.5f, c->params), c);
+		}
+	}
+}
+
 void onDisconnect(Client* client)
 {
+	if (client->peer)
+	{
+		onPeerDisconnect(client);
+		return;
+	}
+
 	cout << "Client " << client->id << " [" << client->socket.getRemoteAddress() << "] " << "disconnected!" << endl;
 
 	// tell client's ESOs to delete the player
@@ -255,9 +454,9 @@ void onDisconnect(Client* client)
 		}
 	}
 
-	if (server.getClients().size() > 1)
+	if (client->room->getList().size() > 1)
 	{
-		for (Client* c : server.getClients())
+		for (Client* c : client->room->getList())
 		{
 			if (c->screenCurrent == client->screenOwned)
 			{
@@ -269,36 +468,114 @@ void onDisconnect(Client* client)
 
 int main(int argc, char const *argv[])
 {
-	if (argc > 1)
+	unsigned int shardCount = Server::DEFAULT_SHARD_COUNT;
+	unsigned short peerPort = 0;
+	std::map<Cross, std::string> peers;
+	bool daemonMode = false;
+	int positional = 0;
+
+	// [port] [shards] --daemon --peer-port <port> --left <ip:port> --right <ip:port> --allow-peer <ip> --wall <id>
+	for (int i = 1; i < argc; ++i)
 	{
-		GameSettings::serverPort = static_cast<unsigned short>(stoul(argv[1]));
+		std::string arg = argv[i];
+
+		if (arg == "--daemon") daemonMode = true;
+		else if (arg.compare(0, 2, "--") != 0)
+		{
+			if (positional++ == 0) GameSettings::serverPort = static_cast<unsigned short>(stoul(arg));
+			else shardCount = static_cast<unsigned int>(stoul(arg));
+		}
+		else if (i + 1 < argc)
+		{
+			std::string value = argv[++i];
+
+			if (arg == "--peer-port") peerPort = static_cast<unsigned short>(stoul(value));
+			else if (arg == "--left") peers[CROSS_LEFT] = value;
+			else if (arg == "--right") peers[CROSS_RIGHT] = value;
+			else if (arg == "--allow-peer") server.allowPeer(value);
+			else if (arg == "--wall") GameSettings::wallID = static_cast<WallID>(stoul(value));
+		}
 	}
 
+	// the servers we link to can link back to us (e.g. after a restart)
+	for (std::map<Cross, std::string>::value_type& peer : peers)
+	{
+		server.allowPeer(peer.second.substr(0, peer.second.rfind(':')));
+	}
+
+	// detach from the terminal before any thread gets started
+	if (daemonMode && daemon(1, 1) != 0)
+	{
+		cerr << "Server failed to daemonize!" << endl;
+		return EXIT_FAILURE;
+	}
+
+	// the stop signals are waited for below, every thread started from here on inherits them blocked
+	sigset_t stopSignals;
+	sigemptyset(&stopSignals);
+	sigaddset(&stopSignals, SIGINT);
+	sigaddset(&stopSignals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &stopSignals, nullptr);
+
 	server.setConnectHandler(onConnect);
 	server.setReceiveHandler(onReceive);
 	server.setDisconnectHandler(onDisconnect);
+	server.setPeerPort(peerPort);
 
-	if (!server.start(GameSettings::serverPort))
+	if (!server.start(GameSettings::serverPort, shardCount))
 	{
 		cerr << "Server failed to start!" << endl;
 		return EXIT_FAILURE;
 	}
 
+	for (std::map<Cross, std::string>::value_type& peer : peers)
+	{
+		size_t colon = peer.second.rfind(':');
+
+		if (colon == std::string::npos ||
+			!server.federate(GameSettings::wallID, peer.first, peer.second.substr(0, colon), static_cast<unsigned short>(stoul(peer.second.substr(colon + 1)))))
+		{
+			cerr << "Failed to link with the peer at " << peer.second << "!" << endl;
+		}
+	}
+
 	cout << "[-Project Parthora-]" << endl;
 	cout << "by Melvin Loho" << endl;
 	cout << endl;
 
-	cout << "Server running on..." << GameSettings::toString() << endl;
-	cout << "Enter k to kill the server!" << endl;
+	cout << "Server running on..." << GameSettings::toString() << "Shards: " << shardCount << endl;
+
+	if (!daemonMode)
+	{
+		cout << "Enter k (or send SIGINT/SIGTERM) to kill the server!" << endl;
+
+		// without a console (EOF) the server just keeps running until it gets a signal
+		std::thread console([]
+		{
+			int c;
+
+			while ((c = getchar()) != EOF)
+			{
+				if (c == 'k')
+				{
+					kill(getpid(), SIGTERM);
+					break;
+				}
+			}
+		});
+
+		console.detach();
+	}
+
 	cout << std::string(80, '-');
 
-	while (getchar() != 'k');
+	int stopSignal;
+	sigwait(&stopSignals, &stopSignal);
 
 	cout << "Server stopping..." << endl;
 
 	server.stop();
-
-	while (server.isRunning());
+	server.wait();
 
 	cout << "Server stopped!" << endl;
 
@@ -3,7 +3,14 @@
  *
  * @date       March 2, 2015
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Preloads the game's resources in the background while the window comes up.
+ *
+ *             October 18, 2026
+ *             Preloads the shader the fireballs are going to use.
+ *
+ *             October 18, 2026
+ *             A fourth argument turns on the render thread.
  *
  * @designer   Melvin Loho
  *
@@ -13,6 +20,7 @@
  */
 
 #include <SFML/Graphics.hpp>
+#include "core/ResourceCache.h"
 #include "engine/AppWindow.h"
 #include "engine/Scene.h"
 #include "GameSettings.h"
@@ -32,6 +40,16 @@ int main(int argc, char const *argv[])
 		if (argc > 2)
 		{
 			GameSettings::serverPort = static_cast<unsigned short>(stoul(argv[2]));
+
+			if (argc > 3)
+			{
+				GameSettings::wallID = static_cast<WallID>(stoul(argv[3]));
+
+				if (argc > 4)
+				{
+					GameSettings::renderThread = stoul(argv[4]) != 0;
+				}
+			}
 		}
 	}
 
@@ -39,6 +57,16 @@ int main(int argc, char const *argv[])
 	cout << "by Melvin Loho" << endl;
 	cout << endl;
 
+	// loaded in the background while the window is being set up
+	ResourceCache::PreloadFont("Data/fonts/consolas.ttf");
+	ResourceCache::PreloadTexture("Data/textures/particle_1.tga");
+	if (sf::Shader::isGeometryAvailable())
+		ResourceCache::PreloadShader("Data/shaders/wave_point.vert", "Data/shaders/wave_point.geom", "Data/shaders/wave_point.frag");
+	else
+		ResourceCache::PreloadShader("Data/shaders/wave.vert", sf::Shader::Vertex);
+	ResourceCache::PreloadSoundBuffer("Data/audio/SWOOSH_loop.wav");
+	ResourceCache::PreloadMusic("Data/audio/gardenparty_mono.wav");
+
 	AppWindow window;
 
 	window.setTimePerFrame(60);
@@ -52,7 +80,11 @@ int main(int argc, char const *argv[])
 
 	window.setScene(Scene::Create<GameScene>(window), false);
 
+	window.setRenderThreaded(GameSettings::renderThread);
+
 	window.run();
 
+	ResourceCache::Clear();
+
 	return EXIT_SUCCESS;
 }
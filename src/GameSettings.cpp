@@ -2,11 +2,14 @@
 
 std::string GameSettings::serverIP = "localhost";
 unsigned short GameSettings::serverPort = 42424;
+WallID GameSettings::wallID = 0;
+bool GameSettings::renderThread = false;
 
 std::string GameSettings::toString()
 {
 	return "\n"
 		"IP:   " + serverIP + "\n" +
-		"Port: " + std::to_string(serverPort) + "\n"
+		"Port: " + std::to_string(serverPort) + "\n" +
+		"Wall: " + std::to_string(wallID) + "\n"
 		;
 }
@@ -2,11 +2,14 @@
 #define GAMESETTINGS_H
 
 #include <string>
+#include "net/Shared.h"
 
 namespace GameSettings
 {
 	extern std::string serverIP;
 	extern unsigned short serverPort;
+	extern WallID wallID;
+	extern bool renderThread;
 
 	std::string toString();
 }
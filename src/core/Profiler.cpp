@@ -0,0 +1,198 @@
+/**
+ * A frame profiler.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @notes      The zones are scoped, nested zones are counted in their parents as well.
+ *             Zones can be timed from any thread, they add up into whichever frame is going on when they end
+ *             (e.g. the render thread's flush lands in the frame after the one it recorded).
+ *             The minimum, average and 99th percentile of every zone are taken over the last HISTORY frames.
+ *             Traces are in the trace event format, one complete ("X") event per scope, in microseconds.
+ */
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+const unsigned int Profiler::HISTORY;
+
+std::mutex Profiler::mutex;
+sf::Clock Profiler::clock;
+
+sf::Int64 Profiler::frameStart = 0;
+sf::Int64 Profiler::frame[ZONE_COUNT] = {};
+sf::Int64 Profiler::history[ZONE_COUNT][HISTORY] = {};
+unsigned int Profiler::historyNext = 0;
+unsigned int Profiler::historyCount = 0;
+Profiler::Summary Profiler::summaries[ZONE_COUNT];
+
+std::vector<Profiler::TraceEvent> Profiler::trace;
+std::map<std::thread::id, unsigned int> Profiler::traceThreads;
+std::string Profiler::tracePath;
+unsigned int Profiler::traceFrames = 0;
+
+Profiler::Scope::Scope(Zone zone) :
+zone(zone),
+start(clock.getElapsedTime().asMicroseconds())
+{}
+
+Profiler::Scope::~Scope()
+{
+	Add(zone, start, clock.getElapsedTime().asMicroseconds() - start);
+}
+
+const char* Profiler::GetName(Zone zone)
+{
+	static const char* const NAMES[ZONE_COUNT] =
+	{
+		"frame",
+		"events",
+		"update",
+		"network",
+		"particles",
+		"render",
+		"render build",
+		"render flush"
+	};
+
+	return NAMES[zone];
+}
+
+void Profiler::EndFrame()
+{
+	const sf::Int64 now = clock.getElapsedTime().asMicroseconds();
+
+	Add(FRAME, frameStart, now - frameStart);
+	frameStart = now;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (unsigned int z = 0; z < ZONE_COUNT; ++z)
+	{
+		history[z][historyNext] = frame[z];
+		frame[z] = 0;
+	}
+
+	historyNext = (historyNext + 1) % HISTORY;
+	historyCount = std::min(historyCount + 1, HISTORY);
+
+	// sorting a copy of the history for the percentile, it's only a few hundred frames
+	sf::Int64 sorted[HISTORY];
+
+	for (unsigned int z = 0; z < ZONE_COUNT; ++z)
+	{
+		std::copy(history[z], history[z] + historyCount, sorted);
+
+		sf::Int64 total = 0;
+		for (unsigned int f = 0; f < historyCount; ++f) total += sorted[f];
+
+		const unsigned int p99 = historyCount * 99 / 100;
+		std::nth_element(sorted, sorted + p99, sorted + historyCount);
+
+		summaries[z].min = sf::microseconds(*std::min_element(sorted, sorted + historyCount));
+		summaries[z].avg = sf::microseconds(total / historyCount);
+		summaries[z].p99 = sf::microseconds(sorted[p99]);
+	}
+
+	if (traceFrames > 0 && --traceFrames == 0)
+	{
+		if (SaveTrace()) std::cout << "Trace saved to " << tracePath << std::endl;
+		else std::cerr << "Could not save the trace to " << tracePath << std::endl;
+
+		trace.clear();
+		traceThreads.clear();
+	}
+}
+
+Profiler::Summary Profiler::GetSummary(Zone zone)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return summaries[zone];
+}
+
+void Profiler::GetHistory(Zone zone, std::vector<float>& times)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	times.resize(historyCount);
+
+	const unsigned int first = (historyNext + HISTORY - historyCount) % HISTORY;
+
+	for (unsigned int f = 0; f < historyCount; ++f)
+	{
+		times[f] = history[zone][(first + f) % HISTORY] / 1000.f;
+	}
+}
+
+void Profiler::StartTrace(const std::string& path, unsigned int frames)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	// a trace already going on is given up on
+	trace.clear();
+	traceThreads.clear();
+
+	tracePath = path;
+	traceFrames = frames;
+}
+
+bool Profiler::IsTracing()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return traceFrames > 0;
+}
+
+void Profiler::Add(Zone zone, sf::Int64 start, sf::Int64 duration)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	frame[zone] += duration;
+
+	if (traceFrames > 0)
+	{
+		// the threads get small IDs in the order they show up
+		const unsigned int thread = traceThreads.insert(std::make_pair(std::this_thread::get_id(), traceThreads.size())).first->second;
+
+		TraceEvent event;
+
+		event.zone = zone;
+		event.thread = thread;
+		event.start = start;
+		event.duration = duration;
+
+		trace.push_back(event);
+	}
+}
+
+bool Profiler::SaveTrace()
+{
+	std::ofstream file(tracePath.c_str());
+
+	if (!file) return false;
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	for (size_t i = 0; i < trace.size(); ++i)
+	{
+		const TraceEvent& event = trace[i];
+
+		file << (i == 0 ? "\n" : ",\n")
+			<< "{\"name\":\"" << GetName(event.zone) << "\",\"cat\":\"frame\",\"ph\":\"X\""
+			<< ",\"ts\":" << event.start << ",\"dur\":" << event.duration
+			<< ",\"pid\":0,\"tid\":" << event.thread << "}";
+	}
+
+	file << "\n]}\n";
+
+	return static_cast<bool>(file);
+}
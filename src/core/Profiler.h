@@ -0,0 +1,96 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SFML/System.hpp>
+
+/**
+ * CPU time spent in the phases of a frame. Each zone adds up the time of its scopes over a frame,
+ * the last frames of every zone are kept around to be summed up (and graphed).
+ * Can record the scopes of a number of frames as a trace, for chrome://tracing to show.
+ */
+class Profiler
+{
+public:
+	enum Zone
+	{
+		FRAME,
+		EVENTS,
+		UPDATE,
+		NETWORK,
+		PARTICLES,
+		RENDER,
+		RENDER_BUILD,
+		RENDER_FLUSH,
+		ZONE_COUNT
+	};
+
+	// Frames kept for each zone
+	static const unsigned int HISTORY = 240;
+
+	// Times whatever happens from its construction to its destruction, on any thread
+	class Scope
+	{
+	public:
+		explicit Scope(Zone zone);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		Zone zone;
+		sf::Int64 start;
+	};
+
+	struct Summary
+	{
+		sf::Time min, avg, p99;
+	};
+
+	static const char* GetName(Zone zone);
+
+	// Moves on to the next frame, what the zones added up goes into their history.
+	// The frame zone is timed from one call to the next.
+	static void EndFrame();
+
+	// Over the frames kept
+	static Summary GetSummary(Zone zone);
+	// From the oldest frame to the last one, in milliseconds
+	static void GetHistory(Zone zone, std::vector<float>& times);
+
+	// Records the scopes of the next frames, saved as trace events (JSON) once they're done
+	static void StartTrace(const std::string& path, unsigned int frames);
+	static bool IsTracing();
+
+private:
+	struct TraceEvent
+	{
+		Zone zone;
+		unsigned int thread;
+		sf::Int64 start, duration;
+	};
+
+	static void Add(Zone zone, sf::Int64 start, sf::Int64 duration);
+	static bool SaveTrace();
+
+	static std::mutex mutex;
+	static sf::Clock clock;
+
+	static sf::Int64 frameStart;
+	static sf::Int64 frame[ZONE_COUNT];
+	static sf::Int64 history[ZONE_COUNT][HISTORY];
+	static unsigned int historyNext, historyCount;
+	static Summary summaries[ZONE_COUNT];
+
+	static std::vector<TraceEvent> trace;
+	static std::map<std::thread::id, unsigned int> traceThreads;
+	static std::string tracePath;
+	static unsigned int traceFrames;
+};
+
+#endif // PROFILER_H
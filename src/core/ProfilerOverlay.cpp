@@ -0,0 +1,162 @@
+/**
+ * The profiler's overlay.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @notes      The summaries are fields of a HUD text, only the ones that changed get laid out again.
+ *             The graph stacks the phases of the game loop (events, updates, rendering and whatever is left of the frame,
+ *             e.g. waiting for vsync) for every frame kept, the oldest one on the left. Its height is twice the target.
+ *             The graph is untextured vertices, it batches with anything else drawn without a texture.
+ */
+
+#include "ProfilerOverlay.h"
+
+#include "Renderer.h"
+
+#include <algorithm>
+
+static const float GRAPH_HEIGHT = 100.f;
+static const float MARGIN = 8.f;
+
+// What the graph stacks, from the bottom up
+static const Profiler::Zone PHASES[] = { Profiler::EVENTS, Profiler::UPDATE, Profiler::RENDER };
+static const sf::Color PHASE_COLORS[] = { sf::Color(255, 200, 0), sf::Color(0, 200, 255), sf::Color(255, 0, 200) };
+static const sf::Color REST_COLOR(100, 100, 100);
+
+ProfilerOverlay::ProfilerOverlay(const sf::Font& font, unsigned int characterSize) :
+text(font, characterSize),
+targetFrameTime(sf::seconds(1.f / 60.f))
+{
+	text.add("[PROFILER]    min / avg / p99 (ms)");
+
+	for (unsigned int z = 0; z < Profiler::ZONE_COUNT; ++z)
+	{
+		std::string name = Profiler::GetName(static_cast<Profiler::Zone>(z));
+		name.resize(13, ' ');
+
+		text.add("\n " + name);
+		fields[z][0] = text.add();
+		text.add(" / ");
+		fields[z][1] = text.add();
+		text.add(" / ");
+		fields[z][2] = text.add();
+	}
+
+	add(text);
+}
+
+void ProfilerOverlay::setPosition(const sf::Vector2f& position)
+{
+	if (this->position == position) return;
+
+	this->position = position;
+
+	invalidateTransform();
+}
+
+void ProfilerOverlay::setTargetFrameTime(const sf::Time& target)
+{
+	targetFrameTime = target;
+}
+
+void ProfilerOverlay::update(const sf::Time& t)
+{
+	// SUMMARIES
+
+	for (unsigned int z = 0; z < Profiler::ZONE_COUNT; ++z)
+	{
+		const Profiler::Summary summary = Profiler::GetSummary(static_cast<Profiler::Zone>(z));
+
+		text.setValue(fields[z][0], summary.min.asMicroseconds() / 1000.0, 2);
+		text.setValue(fields[z][1], summary.avg.asMicroseconds() / 1000.0, 2);
+		text.setValue(fields[z][2], summary.p99.asMicroseconds() / 1000.0, 2);
+	}
+
+	// GRAPH (below the summaries)
+
+	for (unsigned int z = 0; z < Profiler::ZONE_COUNT; ++z)
+	{
+		Profiler::GetHistory(static_cast<Profiler::Zone>(z), times[z]);
+	}
+
+	const sf::FloatRect textBounds = text.getBounds();
+	const float target = targetFrameTime.asMicroseconds() / 1000.f;
+	const float scale = target > 0.f ? GRAPH_HEIGHT / (target * 2.f) : 1.f;
+	const unsigned int frames = times[Profiler::FRAME].size();
+
+	graphPos = sf::Vector2f(textBounds.left, textBounds.top + textBounds.height + MARGIN);
+	graph.clear();
+
+	addRect(graphPos.x, graphPos.y, static_cast<float>(Profiler::HISTORY), GRAPH_HEIGHT, sf::Color(0, 0, 0, 160));
+
+	for (unsigned int f = 0; f < frames; ++f)
+	{
+		const float x = graphPos.x + (Profiler::HISTORY - frames + f);
+		float y = graphPos.y + GRAPH_HEIGHT;
+		float rest = times[Profiler::FRAME][f];
+
+		for (unsigned int p = 0; p < sizeof(PHASES) / sizeof(PHASES[0]); ++p)
+		{
+			const float ms = times[PHASES[p]][f];
+			const float height = std::min(ms * scale, y - graphPos.y);
+
+			y -= height;
+			addRect(x, y, 1.f, height, PHASE_COLORS[p]);
+
+			rest -= ms;
+		}
+
+		const float restHeight = std::min(std::max(rest, 0.f) * scale, y - graphPos.y);
+		addRect(x, y - restHeight, 1.f, restHeight, REST_COLOR);
+	}
+
+	// the target, halfway up
+	addRect(graphPos.x, graphPos.y + GRAPH_HEIGHT * 0.5f, static_cast<float>(Profiler::HISTORY), 1.f, sf::Color::White);
+}
+
+sf::FloatRect ProfilerOverlay::getBounds() const
+{
+	const sf::FloatRect textBounds = text.getBounds();
+
+	sf::FloatRect bounds(
+		std::min(textBounds.left, graphPos.x), textBounds.top,
+		std::max(textBounds.width, static_cast<float>(Profiler::HISTORY)), graphPos.y + GRAPH_HEIGHT - textBounds.top);
+
+	return getLocalTransform().transformRect(bounds);
+}
+
+sf::Transform ProfilerOverlay::computeLocalTransform() const
+{
+	return sf::Transform().translate(position);
+}
+
+void ProfilerOverlay::draw(Renderer& renderer, sf::RenderStates states) const
+{
+	states.transform.combine(getLocalTransform());
+	states.texture = nullptr;
+
+	renderer.draw(graph.data(), graph.size(), sf::PrimitiveType::Triangles, states);
+}
+
+void ProfilerOverlay::addRect(float x, float y, float width, float height, const sf::Color& color)
+{
+	if (width <= 0.f || height <= 0.f) return;
+
+	const sf::Vertex topLeft(sf::Vector2f(x, y), color);
+	const sf::Vertex topRight(sf::Vector2f(x + width, y), color);
+	const sf::Vertex bottomLeft(sf::Vector2f(x, y + height), color);
+	const sf::Vertex bottomRight(sf::Vector2f(x + width, y + height), color);
+
+	graph.push_back(topLeft);
+	graph.push_back(topRight);
+	graph.push_back(bottomLeft);
+	graph.push_back(bottomLeft);
+	graph.push_back(topRight);
+	graph.push_back(bottomRight);
+}
@@ -0,0 +1,42 @@
+#ifndef PROFILEROVERLAY_H
+#define PROFILEROVERLAY_H
+
+#include "Profiler.h"
+#include "object/HGO.h"
+
+/**
+ * The profiler's zones summed up (min / avg / p99), over a graph of the phases of the last frames.
+ * To be drawn in a HUD pass, updated whenever it's shown.
+ */
+class ProfilerOverlay : public BGO
+{
+public:
+	ProfilerOverlay(const sf::Font& font, unsigned int characterSize = 13);
+
+	void setPosition(const sf::Vector2f& position);
+	// The line drawn across the graph, the frame time aimed for
+	void setTargetFrameTime(const sf::Time& target);
+
+	void update(const sf::Time& t) override;
+
+	sf::FloatRect getBounds() const override;
+
+protected:
+	sf::Transform computeLocalTransform() const override;
+	void draw(Renderer& renderer, sf::RenderStates states) const override;
+
+private:
+	void addRect(float x, float y, float width, float height, const sf::Color& color);
+
+	HGO text;
+	HGO::Field fields[Profiler::ZONE_COUNT][3];
+
+	std::vector<sf::Vertex> graph;
+	std::vector<float> times[Profiler::ZONE_COUNT];
+	sf::Vector2f graphPos;
+
+	sf::Vector2f position;
+	sf::Time targetFrameTime;
+};
+
+#endif // PROFILEROVERLAY_H
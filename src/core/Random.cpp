@@ -0,0 +1,60 @@
+/**
+ * A fast random number generator.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @notes      xoshiro128+ by David Blackman and Sebastiano Vigna, seeded through splitmix64.
+ *             Every instance is its own stream, unlike rand() there is no shared state,
+ *             so generators can be used from several threads and reseeded to replay a simulation.
+ *             The lowest bits are the weakest, which is why the floats are made from the highest ones.
+ */
+
+#include "Random.h"
+
+#include <atomic>
+#include <chrono>
+
+sf::Uint64 Random::NewSeed()
+{
+	static std::atomic<sf::Uint64> counter(0);
+
+	// the counter keeps seeds taken within the same clock tick apart
+	return static_cast<sf::Uint64>(std::chrono::high_resolution_clock::now().time_since_epoch().count())
+		+ (++counter) * 0x9E3779B97F4A7C15ULL;
+}
+
+Random::Random(sf::Uint64 seed)
+{
+	this->seed(seed);
+}
+
+void Random::seed(sf::Uint64 seed)
+{
+	// splitmix64 spreads any seed (even 0) over the whole state
+	for (int i = 0; i < 4; i += 2)
+	{
+		sf::Uint64 z = (seed += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		z = z ^ (z >> 31);
+
+		s[i] = static_cast<sf::Uint32>(z);
+		s[i + 1] = static_cast<sf::Uint32>(z >> 32);
+	}
+}
+
+void Random::range(float *out, unsigned int count, float min, float max)
+{
+	const float span = max - min;
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		out[i] = min + uniform() * span;
+	}
+}
@@ -0,0 +1,51 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <SFML/Config.hpp>
+
+class Random
+{
+public:
+	// A seed that differs from one call to the next
+	static sf::Uint64 NewSeed();
+
+	Random(sf::Uint64 seed = NewSeed());
+
+	void seed(sf::Uint64 seed);
+
+	// Uniformly distributed 32 bits
+	inline sf::Uint32 next()
+	{
+		const sf::Uint32 result = s[0] + s[3];
+		const sf::Uint32 t = s[1] << 9;
+
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = (s[3] << 11) | (s[3] >> 21);
+
+		return result;
+	}
+
+	// Uniformly distributed in [0, 1)
+	inline float uniform()
+	{
+		return (next() >> 8) * (1.f / 16777216.f);
+	}
+
+	// Uniformly distributed in [min, max)
+	inline float range(float min, float max)
+	{
+		return min + uniform() * (max - min);
+	}
+
+	// Fills count values uniformly distributed in [min, max)
+	void range(float *out, unsigned int count, float min, float max);
+
+private:
+	sf::Uint32 s[4];
+};
+
+#endif // RANDOM_H
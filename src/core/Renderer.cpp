@@ -3,7 +3,26 @@
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Batches ranges of vertices (e.g. particle systems) along with the sprites.
+ *
+ *             October 18, 2026
+ *             Draws are deferred until the end and sorted to change states as little as possible.
+ *
+ *             October 18, 2026
+ *             The batches are streamed into vertex buffers on the GPU.
+ *
+ *             October 18, 2026
+ *             Game objects out of view are culled.
+ *
+ *             October 18, 2026
+ *             Records frames of passes, to be drawn right away or by a render thread while the next one is recorded.
+ *
+ *             October 18, 2026
+ *             Building (sorting and snapshotting) and flushing (drawing) the frames are profiled.
+ *
+ *             October 18, 2026
+ *             Texts are drawn as the vertex ranges of their glyphs, snapshots only copy vertices.
  *
  * @designer   Melvin Loho
  *
@@ -12,16 +31,86 @@
  * @notes      This renderer features:
  *             > All basic game object rendering
  *             > Sprite batching
+ *             > Vertex range batching, anything drawn with the same texture, blend mode and shader
+ *               in a row goes out in a single draw call
+ *             > A render queue, everything drawn between begin() and end() is sorted by a 64 bit key
+ *               before being drawn, so that whatever can share a batch ends up next to each other
+ *             > View culling of game objects
+ *             > Streaming, the batched vertices are written once per frame, straight from where they were built
+ *               into a ring of stream vertex buffers (needs SFML 2.5, falls back to drawing from memory)
+ *             > Double buffered frames, the passes (begin() to end()) and clears are recorded into one frame
+ *               while the other one is drawn. A snapshot of a frame copies the vertices it points at,
+ *               so that it can be drawn on another thread while the game goes on changing them.
+ *
+ *             The sort key, from the most significant bit:
+ *             layer (8) | run (28) | shader (12) | texture (12) | blend mode (4)
+ *             Layers are always drawn in order. Within a layer, the draws keep their submission order by runs:
+ *             additively blended draws give the same result in any order, so the ones submitted in a row
+ *             make up a single run and get sorted by their states, anything else is a run of its own.
+ *             The sort is stable, draws with the same key stay in the order they were submitted in.
  */
 
 #include "Renderer.h"
 
 #include "object/BGO.h"
 #include "object/SGO.h"
-#include "object/TGO.h"
+#include "Profiler.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
+static const unsigned int LAYER_SHIFT = 56;
+static const unsigned int ID_BITS = 12;
+static const unsigned int BLEND_BITS = 4;
+static const unsigned int STATE_BITS = ID_BITS + ID_BITS + BLEND_BITS;
+static const sf::Uint32 RUN_MAX = (1u << (LAYER_SHIFT - STATE_BITS)) - 1;
+
+static bool IsIdentity(const sf::Transform& transform)
+{
+	return std::memcmp(transform.getMatrix(), sf::Transform::Identity.getMatrix(), 16 * sizeof(float)) == 0;
+}
+
+static bool StatesDiffer(const sf::RenderStates& a, const sf::RenderStates& b)
+{
+	return a.texture != b.texture || a.shader != b.shader || a.blendMode != b.blendMode;
+}
+
+// Too many different states only makes some of them share an ID, they still get drawn with their own states
+static sf::Uint64 StateID(std::vector<const void*>& ids, const void* state)
+{
+	if (!state) return 0;
+
+	for (size_t i = 0; i < ids.size(); ++i)
+	{
+		if (ids[i] == state) return i + 1;
+	}
+
+	if (ids.size() + 1 < (1u << ID_BITS)) ids.push_back(state);
+
+	return ids.size();
+}
+
+/**
+ * Gets the bounds of the area that a view shows, in world coordinates.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      view The view
+ *
+ * @return     The bounds (of the whole rotated area if the view is rotated)
+ */
+sf::FloatRect Renderer::GetViewBounds(const sf::View& view)
+{
+	return view.getInverseTransform().transformRect(sf::FloatRect(-1.f, -1.f, 2.f, 2.f));
+}
+
 /**
  * Constructor.
  *
@@ -30,6 +119,15 @@
  * @revisions  2015-03-17
  *             Made the renderer more generic by counting vertices instead of sprites.
  *
+ *             October 18, 2026
+ *             The buffer grows to hold a range of vertices bigger than it.
+ *
+ *             October 18, 2026
+ *             The buffers are on the GPU when vertex buffers are available.
+ *
+ *             October 18, 2026
+ *             Starts recording into the first of its two frames.
+ *
  * @designer   Melvin Loho
  *
  * @programmer Melvin Loho
@@ -39,24 +137,29 @@
  */
 Renderer::Renderer(sf::RenderTarget &renderer, unsigned int maxVertices) :
 renderer(renderer),
-vertices(new sf::Vertex[maxVertices]),
+recording(0), passFirst(0),
+layer(0),
+stream(0), streamCount(0), batchFirst(0),
+streaming(sf::VertexBuffer::isAvailable()),
+batchType(sf::PrimitiveType::Triangles),
 maxCount(maxVertices), count(0),
-count_drawcalls(0), count_cumulative(0),
+count_drawcalls(0), count_cumulative(0), count_statechanges(0),
+frameStats(),
 active(false)
 {
-	for (unsigned int v = 0; v < maxVertices; ++v)
-	{
-		vertices[v] = sf::Vertex();
-	}
+	frames[0].stats = frames[1].stats = Stats();
+
+	// the stream buffers only get created once there is something to put in them
+	for (sf::VertexBuffer &buffer : streams) buffer.setUsage(sf::VertexBuffer::Stream);
+
+	if (!streaming) vertices.resize(maxVertices);
 }
 
 /**
  * Destructor.
  */
 Renderer::~Renderer()
-{
-	delete[] vertices;
-}
+{}
 
 ////////////////////////////////////////////////////////////
 /// Wrapper for SFML's draw method.
@@ -89,8 +192,25 @@ void Renderer::sf_draw(const sf::Vertex* vertices, unsigned int vertexCount,
 	renderer.draw(vertices, vertexCount, type, states);
 }
 
+////////////////////////////////////////////////////////////
+/// Wrapper for SFML's draw method.
+/// \brief Draw primitives from a vertex buffer
+///
+/// \param vertexBuffer Vertex buffer
+/// \param firstVertex  Index of the first vertex to render
+/// \param vertexCount  Number of vertices to render
+/// \param states       Render states to use for drawing
+///
+////////////////////////////////////////////////////////////
+void Renderer::sf_draw(const sf::VertexBuffer& vertexBuffer, unsigned int firstVertex, unsigned int vertexCount,
+	const sf::RenderStates& states = sf::RenderStates::Default)
+{
+	++count_drawcalls;
+	renderer.draw(vertexBuffer, firstVertex, vertexCount, states);
+}
+
 /**
- * Gets the amount of draw calls made since the last rendering.
+ * Gets the amount of draw calls made in the last frame done drawing.
  *
  * @date       2015-02-25
  *
@@ -104,11 +224,11 @@ void Renderer::sf_draw(const sf::Vertex* vertices, unsigned int vertexCount,
  */
 unsigned Renderer::getDrawCallCount() const
 {
-	return count_drawcalls;
+	return frameStats.drawcalls;
 }
 
 /**
- * Gets the amount of sprites drawn since the last rendering.
+ * Gets the amount of sprites drawn in the last frame done drawing.
  *
  * @date       2015-02-25
  *
@@ -122,7 +242,120 @@ unsigned Renderer::getDrawCallCount() const
  */
 unsigned Renderer::getSpriteCount() const
 {
-	return count_cumulative / SPRITE_VERTICES;
+	return frameStats.cumulative / SPRITE_VERTICES;
+}
+
+/**
+ * Gets the amount of times the texture, shader or blend mode changed between draw calls in the last frame done drawing.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @return     The number of state changes
+ */
+unsigned Renderer::getStateChangeCount() const
+{
+	return frameStats.statechanges;
+}
+
+/**
+ * Gets the amount of draw calls that drawing in the submission order would have made in the last frame done drawing.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @return     The number of draw calls without sorting
+ */
+unsigned Renderer::getUnsortedDrawCallCount() const
+{
+	return frameStats.unsorted_drawcalls;
+}
+
+/**
+ * Gets the amount of state changes that drawing in the submission order would have made in the last frame done drawing.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @return     The number of state changes without sorting
+ */
+unsigned Renderer::getUnsortedStateChangeCount() const
+{
+	return frameStats.unsorted_statechanges;
+}
+
+/**
+ * Gets the amount of game objects left out for being out of view in the last frame done drawing.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @return     The number of culled game objects
+ */
+unsigned Renderer::getCulledCount() const
+{
+	return frameStats.culled;
+}
+
+/**
+ * Sets whether the batches are streamed into vertex buffers or drawn from memory.
+ * Streaming is only turned on if vertex buffers are available.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      streaming Whether to stream the batches
+ */
+void Renderer::setStreaming(bool streaming)
+{
+	this->streaming = streaming && sf::VertexBuffer::isAvailable();
+
+	stream = streamCount = batchFirst = 0;
+
+	if (!this->streaming && vertices.size() < maxCount) vertices.resize(maxCount);
+}
+
+/**
+ * Gets whether the batches are streamed into vertex buffers.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @return     Whether the batches are streamed
+ */
+bool Renderer::isStreaming() const
+{
+	return streaming;
 }
 
 /**
@@ -131,18 +364,47 @@ unsigned Renderer::getSpriteCount() const
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Starts a pass seen through the current view of the render target.
  *
  * @designer   Melvin Loho
  *
  * @programmer Melvin Loho
  */
 void Renderer::begin()
+{
+	begin(renderer.getView());
+}
+
+/**
+ * Starts a pass seen through the specified view.
+ * The view is set on the render target when the pass gets drawn.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      view The view
+ */
+void Renderer::begin(const sf::View& view)
 {
 	if (active) throw "Renderer is already active.";
 
-	count = 0;
 	states = sf::RenderStates::Default;
+	layer = 0;
+	std::fill(runs, runs + LAYER_COUNT, Run());
+	passView = view;
+	viewBounds = GetViewBounds(view);
+	passFirst = frames[recording].commands.size();
+
+	shaderIDs.clear();
+	textureIDs.clear();
+	blendIDs.clear();
+
 	active = true;
 }
 
@@ -153,7 +415,11 @@ void Renderer::begin()
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Sorts and renders everything submitted since begin().
+ *
+ *             October 18, 2026
+ *             Sorts the pass into the frame being recorded, it gets rendered along with the frame.
  *
  * @designer   Melvin Loho
  *
@@ -163,24 +429,234 @@ void Renderer::end()
 {
 	if (!active) throw "Renderer is not active.";
 
-	flushSprites();
+	Profiler::Scope building(Profiler::RENDER_BUILD);
+
+	Frame &frame = frames[recording];
+
+	// what it would have taken without sorting, counted the same way as when drawing
+	sf::RenderStates last = sf::RenderStates::Default;
+	sf::PrimitiveType lastType = sf::PrimitiveType::Triangles;
+	bool batching = false;
+
+	for (unsigned int c = passFirst; c < frame.commands.size(); ++c)
+	{
+		const Command &command = frame.commands[c];
+
+		if (!batching || command.type != lastType || StatesDiffer(command.states, last))
+		{
+			++frame.stats.unsorted_drawcalls;
+			if (StatesDiffer(command.states, last)) ++frame.stats.unsorted_statechanges;
+
+			last = command.states;
+			lastType = command.type;
+			batching = true;
+		}
+	}
+
+	passOrder.resize(frame.commands.size() - passFirst);
+
+	for (unsigned int c = passFirst; c < frame.commands.size(); ++c)
+	{
+		passOrder[c - passFirst].key = frame.commands[c].key;
+		passOrder[c - passFirst].command = c;
+	}
+
+	Sort(passOrder, orderScratch);
+
+	Pass pass;
+
+	pass.view = passView;
+	pass.first = frame.order.size();
+	pass.count = passOrder.size();
+	pass.clear = false;
+
+	frame.order.insert(frame.order.end(), passOrder.begin(), passOrder.end());
+	frame.passes.push_back(pass);
+
 	active = false;
 }
 
 /**
-* Resets the statistics of the renderer.
-*
-* @date       2015-02-28
-*
-* @revisions
-*
-* @designer   Melvin Loho
-*
-* @programmer Melvin Loho
-*/
-void Renderer::resetStats()
+ * Clears the render target when the frame gets drawn, over whatever the passes before it drew.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      color The colour to clear it with
+ */
+void Renderer::clear(const sf::Color& color)
 {
-	count_drawcalls = count_cumulative = 0;
+	if (active) throw "Renderer is active, clear before begin() or after end().";
+
+	Frame &frame = frames[recording];
+
+	Pass pass;
+
+	pass.first = frame.order.size();
+	pass.count = 0;
+	pass.clear = true;
+	pass.clearColor = color;
+
+	frame.passes.push_back(pass);
+}
+
+/**
+ * Hands the recorded frame over to be drawn and starts recording the next one
+ * into the frame drawn before, whose stats become the ones shown.
+ * Whoever draws the frames must be done with the last one.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      snapshot Whether to copy whatever the recorded frame points at,
+ *                      for it to be drawn while the vertices it was recorded from change
+ */
+void Renderer::swapFrames(bool snapshot)
+{
+	if (active) throw "Renderer is active.";
+
+	if (snapshot)
+	{
+		Profiler::Scope building(Profiler::RENDER_BUILD);
+
+		this->snapshot(frames[recording]);
+	}
+
+	recording ^= 1;
+
+	Frame &frame = frames[recording];
+
+	frameStats = frame.stats;
+
+	frame.passes.clear();
+	frame.commands.clear();
+	frame.order.clear();
+	frame.staged.clear();
+	frame.stats = Stats();
+}
+
+/**
+ * Draws the frame handed over by the last swap, pass after pass.
+ * Called from the thread the render target is active on.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ */
+void Renderer::drawFrame()
+{
+	Profiler::Scope flushing(Profiler::RENDER_FLUSH);
+
+	Frame &frame = frames[recording ^ 1];
+
+	count_drawcalls = count_cumulative = count_statechanges = 0;
+
+	for (const Pass &pass : frame.passes)
+	{
+		if (pass.clear)
+		{
+			renderer.clear(pass.clearColor);
+			continue;
+		}
+
+		renderer.setView(pass.view);
+
+		count = 0;
+		batchStates = lastStates = sf::RenderStates::Default;
+		batchType = sf::PrimitiveType::Triangles;
+
+		// the buffer written by the last pass may still be in use
+		stream = (stream + 1) % STREAM_BUFFERS;
+		streamCount = 0;
+
+		for (unsigned int i = pass.first; i < pass.first + pass.count; ++i)
+		{
+			execute(frame, frame.commands[frame.order[i].command]);
+		}
+
+		flush();
+	}
+
+	frame.stats.drawcalls = count_drawcalls;
+	frame.stats.cumulative = count_cumulative;
+	frame.stats.statechanges = count_statechanges;
+}
+
+/**
+ * Sets the layer of everything drawn from now on, until the next begin().
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      layer The layer, drawn over the lower ones
+ */
+void Renderer::setLayer(sf::Uint8 layer)
+{
+	this->layer = layer;
+}
+
+/**
+ * Gets the layer of whatever gets drawn next.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @return     The layer
+ */
+sf::Uint8 Renderer::getLayer() const
+{
+	return layer;
+}
+
+/**
+ * Checks whether something is in the view of the pass.
+ * Counts what is not as culled.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      bounds    The bounds of what is to be drawn (BGO::NO_BOUNDS is always visible)
+ * @param      transform The transformation it is drawn with
+ *
+ * @return     Whether it is visible
+ */
+bool Renderer::isVisible(const sf::FloatRect& bounds, const sf::Transform& transform)
+{
+	if (bounds.width < 0.f) return true;
+
+	if (transform.transformRect(bounds).intersects(viewBounds)) return true;
+
+	++frames[recording].stats.culled;
+	return false;
 }
 
 /**
@@ -262,9 +738,37 @@ void Renderer::draw(const SGO &sgo, sf::RenderStates states)
 }
 
 /**
- * Draws the specified TGO.
+ * Batches a range of vertices.
+ * It joins the vertices batched before it if they share its primitive type, texture, blend mode and shader.
  *
- * @date       2015-02-25
+ * @date       October 18, 2026
+ *
+ * @revisions  October 18, 2026
+ *             Only submits the vertices, they have to stay around until end().
+ *
+ *             October 18, 2026
+ *             They have to stay around until the frame is drawn, or swapped with a snapshot.
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      vertices    The vertices, whole primitives only
+ * @param      vertexCount The number of vertices
+ * @param      type        The type of primitives they make up
+ * @param      states      The render states
+ */
+void Renderer::draw(const sf::Vertex* vertices, unsigned int vertexCount, sf::PrimitiveType type, sf::RenderStates states)
+{
+	if (vertexCount == 0) return;
+
+	submit(states, type, vertices, 0, vertexCount);
+}
+
+/**
+ * Queues a draw up, to be sorted and drawn at the end.
+ *
+ * @date       October 18, 2026
  *
  * @revisions
  *
@@ -272,21 +776,173 @@ void Renderer::draw(const SGO &sgo, sf::RenderStates states)
  *
  * @programmer Melvin Loho
  *
- * @param      tgo    The specified TGO
- * @param      states The render states
+ * @param      states      The render states
+ * @param      type        The type of primitives of the vertices
+ * @param      vertices    The vertices, or null if they are staged
+ * @param      first       The first staged vertex
+ * @param      vertexCount The number of vertices
  */
-void Renderer::draw(const TGO &tgo, sf::RenderStates states)
+void Renderer::submit(const sf::RenderStates &states, sf::PrimitiveType type,
+	const sf::Vertex *vertices, unsigned int first, unsigned int vertexCount)
 {
 	if (!active) throw "Renderer is not active.";
 
-	// Combine transformations with the object's local transformations
-	states.transform.combine(tgo.getLocalTransform());
+	Command command;
 
-	flushSprites();
+	command.key = makeKey(states);
+	command.states = states;
+	command.type = type;
+	command.vertices = vertices;
+	command.first = first;
+	command.vertexCount = vertexCount;
 
-	sf_draw(tgo.text(), states);
+	frames[recording].commands.push_back(command);
 }
 
+/**
+ * Makes the sort key of the next submission.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      states The render states of the submission
+ *
+ * @return     The sort key
+ */
+sf::Uint64 Renderer::makeKey(const sf::RenderStates &states)
+{
+	sf::Uint64 blend = 0;
+
+	while (blend < blendIDs.size() && blendIDs[blend] != states.blendMode) ++blend;
+	if (blend == blendIDs.size() && blend + 1 < (1u << BLEND_BITS)) blendIDs.push_back(states.blendMode);
+	blend = std::min<sf::Uint64>(blend, (1u << BLEND_BITS) - 1);
+
+	const sf::Uint64 state =
+		(StateID(shaderIDs, states.shader) << (ID_BITS + BLEND_BITS))
+		| (StateID(textureIDs, states.texture) << BLEND_BITS)
+		| blend;
+
+	// additive draws in a row share a run, anything else starts one of its own (and so does the additive draw after it)
+	Run& run = runs[layer];
+	const bool additive = states.blendMode == sf::BlendAdd;
+
+	if (!additive || !run.additive) run.index = std::min(run.index + 1, RUN_MAX);
+	run.additive = additive;
+
+	return (static_cast<sf::Uint64>(layer) << LAYER_SHIFT) | (static_cast<sf::Uint64>(run.index) << STATE_BITS) | state;
+}
+
+/**
+ * Sorts by key with a least significant digit radix sort, a byte at a time.
+ * It's stable, draws with the same key keep their submission order.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      items   The items to sort
+ * @param      scratch Room for the passes to write into
+ */
+void Renderer::Sort(std::vector<SortItem> &items, std::vector<SortItem> &scratch)
+{
+	scratch.resize(items.size());
+
+	for (unsigned int shift = 0; shift < 64; shift += 8)
+	{
+		unsigned int offsets[256] = {};
+
+		for (const SortItem &item : items) ++offsets[(item.key >> shift) & 0xFF];
+
+		// nothing to do when every key has the same byte here (e.g. the layer, most of the time)
+		if (offsets[(items.empty() ? 0 : items.front().key >> shift) & 0xFF] == items.size()) continue;
+
+		unsigned int total = 0;
+
+		for (unsigned int &offset : offsets)
+		{
+			unsigned int n = offset;
+			offset = total;
+			total += n;
+		}
+
+		for (const SortItem &item : items) scratch[offsets[(item.key >> shift) & 0xFF]++] = item;
+
+		items.swap(scratch);
+	}
+}
+
+/**
+ * Copies whatever the commands of a frame point at into the frame itself.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      frame The frame
+ */
+void Renderer::snapshot(Frame &frame)
+{
+	for (Command &command : frame.commands)
+	{
+		if (command.vertices)
+		{
+			command.first = frame.staged.size();
+			frame.staged.insert(frame.staged.end(), command.vertices, command.vertices + command.vertexCount);
+			command.vertices = nullptr;
+		}
+	}
+}
+
+/**
+ * Draws a submission, batching it if it can be.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions  October 18, 2026
+ *             Staged vertices are in the frame being drawn.
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      frame   The frame being drawn
+ * @param      command The submission
+ */
+void Renderer::execute(const Frame &frame, const Command &command)
+{
+	const sf::Vertex *source = command.vertices ? command.vertices : &frame.staged[command.first];
+
+	// Batches share a transform, so the vertices get transformed on their way in
+	sf::RenderStates states = command.states;
+
+	if (!IsIdentity(states.transform))
+	{
+		transformed.assign(source, source + command.vertexCount);
+
+		for (sf::Vertex &vertex : transformed)
+		{
+			vertex.position = states.transform.transformPoint(vertex.position);
+		}
+
+		source = transformed.data();
+		states.transform = sf::Transform::Identity;
+	}
+
+	upload(source, command.vertexCount, prepareBatch(states, command.type, command.vertexCount));
+}
 /**
  * Merges "toMerge" with this renderer's RenderStates.
  *
@@ -312,9 +968,10 @@ void Renderer::mergeRenderStates(sf::RenderStates& toMerge) const
 }
 
 /**
- * Prepares the renderer to batch the next sprite.
+ * Prepares the renderer to batch the next vertices.
+ * Renders what was batched so far if the next vertices can't join it.
  *
- * @date       2015-02-25
+ * @date       October 18, 2026
  *
  * @revisions
  *
@@ -322,28 +979,84 @@ void Renderer::mergeRenderStates(sf::RenderStates& toMerge) const
  *
  * @programmer Melvin Loho
  *
- * @param      texture The upcoming texture to be used for the renderer
+ * @param      states      The render states of the next vertices (without a transform)
+ * @param      type        The type of primitives of the next vertices
+ * @param      vertexCount The number of next vertices
  *
- * @return     The index of the first vertex to be used for the renderer
+ * @return     Where the next vertices go (in the stream buffer, or in the batch)
  */
-unsigned int Renderer::prepareSpriteDrawing(const sf::Texture &texture)
+unsigned int Renderer::prepareBatch(const sf::RenderStates &states, sf::PrimitiveType type, unsigned int vertexCount)
 {
-	if (!active) throw "Renderer is not active.";
+	if (type != batchType
+		|| states.texture != batchStates.texture
+		|| states.shader != batchStates.shader
+		|| states.blendMode != batchStates.blendMode)
+	{
+		flush();
+
+		batchStates = states;
+		batchType = type;
+	}
+	else if (count + vertexCount > maxCount)
+	{
+		flush();
+	}
+
+	unsigned int offset;
 
-	if (&texture != this->states.texture)
+	if (streaming)
 	{
-		flushSprites();
-		this->states.texture = &texture;
+		// out of room, move on to the next buffer of the ring
+		if (streamCount + vertexCount > streams[stream].getVertexCount())
+		{
+			flush();
+
+			if (streamCount > 0)
+			{
+				stream = (stream + 1) % STREAM_BUFFERS;
+				streamCount = 0;
+			}
+
+			// a single range bigger than the whole buffer still goes out in one go
+			if (vertexCount > streams[stream].getVertexCount()) streams[stream].create(std::max(vertexCount, maxCount));
+		}
+
+		if (count == 0) batchFirst = streamCount;
+
+		offset = streamCount;
+		streamCount += vertexCount;
 	}
-	else if (count + SPRITE_VERTICES > maxCount)
+	else
 	{
-		flushSprites();
+		if (vertexCount > vertices.size()) vertices.resize(vertexCount);
+
+		offset = count;
 	}
 
-	unsigned int oldCount = count;
-	count += SPRITE_VERTICES;
+	count += vertexCount;
 
-	return oldCount;
+	return offset;
+}
+
+/**
+ * Writes vertices into the batch, straight into the stream buffer when there is one.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      source      The vertices
+ * @param      vertexCount The number of vertices
+ * @param      offset      Where they go, as given by prepareBatch()
+ */
+void Renderer::upload(const sf::Vertex *source, unsigned int vertexCount, unsigned int offset)
+{
+	if (streaming) streams[stream].update(source, vertexCount, offset);
+	else std::memcpy(&vertices[offset], source, vertexCount * sizeof(sf::Vertex));
 }
 
 /**
@@ -352,7 +1065,8 @@ unsigned int Renderer::prepareSpriteDrawing(const sf::Texture &texture)
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             The vertices are staged until the sprite gets drawn at the end.
  *
  * @designer   Melvin Loho
  *
@@ -363,38 +1077,58 @@ unsigned int Renderer::prepareSpriteDrawing(const sf::Texture &texture)
  */
 void Renderer::batchSprite(const sf::Texture &texture, const sf::Vertex *vertices)
 {
-	unsigned int idx = prepareSpriteDrawing(texture);
+	std::vector<sf::Vertex> &staged = frames[recording].staged;
+	unsigned int first = staged.size();
 
-	sf::Vertex *ptr = &Renderer::vertices[idx];
+	staged.insert(staged.end(), vertices, vertices + SPRITE_VERTICES);
 
-	for (unsigned int vc = 0; vc < SPRITE_VERTICES; ++vc)
-	{
-		*ptr++ = *vertices++;
-	}
+	submit(sf::RenderStates(this->states.blendMode, sf::Transform::Identity, &texture, this->states.shader),
+		sf::PrimitiveType::Triangles, nullptr, first, SPRITE_VERTICES);
 }
 
 /**
-* Renders all of the sprites in the buffer and "empties" it.
+* Renders all of the vertices in the buffer and "empties" it.
 *
 * @date       2015-02-25
 *
-* @revisions
+* @revisions  October 18, 2026
+*             Renders whatever kind of batch is in the buffer.
+*
+*             October 18, 2026
+*             Renders the batch from the stream buffer.
 *
 * @designer   Melvin Loho
 *
 * @programmer Melvin Loho
 */
-void Renderer::flushSprites()
+void Renderer::flush()
 {
 	if (count == 0) return;
 	count_cumulative += count;
 
-	sf_draw(
-		vertices,
-		count,
-		sf::PrimitiveType::Triangles,
-		states
-		);
+	if (StatesDiffer(batchStates, lastStates)) ++count_statechanges;
+	lastStates = batchStates;
+
+	if (streaming)
+	{
+		streams[stream].setPrimitiveType(batchType);
+
+		sf_draw(
+			streams[stream],
+			batchFirst,
+			count,
+			batchStates
+			);
+	}
+	else
+	{
+		sf_draw(
+			vertices.data(),
+			count,
+			batchType,
+			batchStates
+			);
+	}
 
 	count = 0;
 }
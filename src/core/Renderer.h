@@ -1,6 +1,7 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include <vector>
 #include <SFML/Graphics.hpp>
 
 #define SPRITE_VERTICES 6
@@ -9,11 +10,13 @@
 
 class BGO;
 class SGO;
-class TGO;
 
 class Renderer
 {
 public:
+	// The area of the world that the view shows
+	static sf::FloatRect GetViewBounds(const sf::View& view);
+
 	Renderer(sf::RenderTarget& renderTarget, unsigned int maxVertices = 1000 * SPRITE_VERTICES);
 
 	~Renderer();
@@ -21,30 +24,150 @@ public:
 	void sf_draw(const sf::Drawable& drawable, const sf::RenderStates& states);
 	void sf_draw(const sf::Vertex* vertices, unsigned int vertexCount,
 		sf::PrimitiveType type, const sf::RenderStates& states);
+	void sf_draw(const sf::VertexBuffer& vertexBuffer, unsigned int firstVertex, unsigned int vertexCount,
+		const sf::RenderStates& states);
 
+	// Of the last frame done drawing
 	unsigned getDrawCallCount() const;
 	unsigned getSpriteCount() const;
+	unsigned getStateChangeCount() const;
+	// What drawing everything in the order it was submitted would have taken
+	unsigned getUnsortedDrawCallCount() const;
+	unsigned getUnsortedStateChangeCount() const;
+	unsigned getCulledCount() const;
+
+	// Streams the batches into vertex buffers when they're available (the default), or draws them from memory.
+	// Not while a frame is being drawn.
+	void setStreaming(bool streaming);
+	bool isStreaming() const;
 
+	// Starts a pass, everything drawn until end() is seen through the view
 	void begin();
+	void begin(const sf::View& view);
 	void end();
-	void resetStats();
+	// Clears the render target, in between passes
+	void clear(const sf::Color& color = sf::Color::Black);
+
+	// The passes are recorded into one frame while the other one is drawn.
+	// Swapping hands the recorded frame over to be drawn and starts recording the next one.
+	// A snapshot copies whatever the frame points at, for it to be drawn while the game carries on.
+	void swapFrames(bool snapshot);
+	// Draws the frame handed over by the last swap, from whichever thread the render target is active on
+	void drawFrame();
+
+	// Whatever is drawn on a layer is drawn over everything of the layers below it, back to 0 with every begin()
+	void setLayer(sf::Uint8 layer);
+	sf::Uint8 getLayer() const;
+
+	// Whether something with these bounds would show up in the view of the pass
+	bool isVisible(const sf::FloatRect& bounds, const sf::Transform& transform = sf::Transform::Identity);
 
 	void draw(const BGO* bgo, sf::RenderStates states = sf::RenderStates::Default);
 	void draw(const SGO& sgo, sf::RenderStates states = sf::RenderStates::Default);
-	void draw(const TGO& tgo, sf::RenderStates states = sf::RenderStates::Default);
+	void draw(const sf::Vertex* vertices, unsigned int vertexCount, sf::PrimitiveType type, sf::RenderStates states = sf::RenderStates::Default);
 
 	sf::RenderStates states;
 
 private:
+	// A submission, drawn once everything has been submitted and sorted
+	struct Command
+	{
+		sf::Uint64 key;
+		sf::RenderStates states;
+		sf::PrimitiveType type;
+		const sf::Vertex *vertices; // null when the vertices are staged
+		unsigned int first, vertexCount;
+	};
+
+	struct SortItem
+	{
+		sf::Uint64 key;
+		unsigned int command;
+	};
+
+	// Draws of a layer that may be reordered among themselves (additive ones submitted in a row)
+	struct Run
+	{
+		sf::Uint32 index;
+		bool additive;
+
+		Run() : index(0), additive(false) {}
+	};
+
+	static const unsigned int LAYER_COUNT = 256;
+
+	struct Stats
+	{
+		unsigned int drawcalls, cumulative, statechanges;
+		unsigned int unsorted_drawcalls, unsorted_statechanges, culled;
+	};
+
+	// What was drawn between begin() and end(), or a clear
+	struct Pass
+	{
+		sf::View view;
+		unsigned int first, count; // of the frame's sorted commands
+		bool clear;
+		sf::Color clearColor;
+	};
+
+	struct Frame
+	{
+		std::vector<Pass> passes;
+		std::vector<Command> commands;
+		// the commands of each pass, sorted, one pass after the other
+		std::vector<SortItem> order;
+		std::vector<sf::Vertex> staged;
+		Stats stats;
+	};
+
+	static void Sort(std::vector<SortItem> &items, std::vector<SortItem> &scratch);
+
 	void mergeRenderStates(sf::RenderStates& toMerge) const;
-	unsigned int prepareSpriteDrawing(const sf::Texture &texture);
+	void submit(const sf::RenderStates &states, sf::PrimitiveType type,
+		const sf::Vertex *vertices, unsigned int first, unsigned int vertexCount);
+	sf::Uint64 makeKey(const sf::RenderStates &states);
+	void snapshot(Frame &frame);
+	void execute(const Frame &frame, const Command &command);
+	unsigned int prepareBatch(const sf::RenderStates &states, sf::PrimitiveType type, unsigned int vertexCount);
+	void upload(const sf::Vertex *source, unsigned int vertexCount, unsigned int offset);
 	void batchSprite(const sf::Texture &texture, const sf::Vertex *vertices);
-	void flushSprites();
+	void flush();
 
 	sf::RenderTarget &renderer;
-	sf::Vertex *vertices;
+
+	// SUBMISSIONS (recorded into frames[recording], the other frame is the one drawn)
+	Frame frames[2];
+	unsigned int recording, passFirst;
+	std::vector<SortItem> passOrder, orderScratch;
+	sf::View passView;
+	// Small IDs of the states seen since begin(), 0 being none
+	std::vector<const void*> shaderIDs, textureIDs;
+	std::vector<sf::BlendMode> blendIDs;
+	sf::Uint8 layer;
+	// The run each layer is on, draws only get reordered within their run
+	Run runs[LAYER_COUNT];
+	sf::FloatRect viewBounds;
+
+	// BATCHING
+	// The batches are streamed into GPU buffers straight from wherever their vertices are,
+	// a ring of them so that a frame doesn't have to wait on the buffers of the frames still being drawn
+	static const unsigned int STREAM_BUFFERS = 3;
+	sf::VertexBuffer streams[STREAM_BUFFERS];
+	unsigned int stream, streamCount, batchFirst;
+	bool streaming;
+	// Holds the batch instead when vertex buffers aren't available
+	std::vector<sf::Vertex> vertices;
+	// Vertices that need to be transformed before they can join a batch
+	std::vector<sf::Vertex> transformed;
+	// What the batched vertices are drawn with, a change of any of it starts a new batch
+	sf::RenderStates batchStates;
+	sf::PrimitiveType batchType;
 	unsigned int maxCount, count;
-	unsigned int count_drawcalls, count_cumulative;
+	// counted while drawing a frame, kept along with the rest of its stats once it's done
+	unsigned int count_drawcalls, count_cumulative, count_statechanges;
+	Stats frameStats;
+	sf::RenderStates lastStates;
 	bool active;
 };
 
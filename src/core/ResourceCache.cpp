@@ -0,0 +1,250 @@
+/**
+ * A cache of shared resources.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions  October 18, 2026
+ *             Shaders made of a vertex, a geometry and a fragment shader.
+ *
+ *             October 18, 2026
+ *             Waiting for a resource doesn't hold on to its entry, which a purge or a clear can erase.
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @notes      Textures, shaders, fonts, sound buffers and music, each one loaded once and keyed by its path.
+ *             Preloading queues the loading up for a background thread (with its own OpenGL context),
+ *             so that nothing has to hit the disk once the game is running.
+ *             A resource that wasn't preloaded is loaded on the spot by whoever asks for it first.
+ */
+
+#include "ResourceCache.h"
+
+#include <iostream>
+
+std::mutex ResourceCache::mutex;
+std::condition_variable ResourceCache::changed;
+
+ResourceCache::Cache<sf::Texture> ResourceCache::textures;
+ResourceCache::Cache<sf::Shader> ResourceCache::shaders;
+ResourceCache::Cache<sf::Font> ResourceCache::fonts;
+ResourceCache::Cache<sf::SoundBuffer> ResourceCache::soundBuffers;
+ResourceCache::Cache<sf::Music> ResourceCache::music;
+
+std::deque<std::function<void()>> ResourceCache::toLoad;
+std::thread ResourceCache::loader;
+bool ResourceCache::loading = false;
+
+// The same file can be loaded as different kinds of shaders
+static std::string ShaderKey(const std::string& path, sf::Shader::Type type)
+{
+	return path + "#" + std::to_string(static_cast<int>(type));
+}
+
+static std::string ShaderKey(const std::string& vertexPath, const std::string& geometryPath, const std::string& fragmentPath)
+{
+	return vertexPath + "#" + geometryPath + "#" + fragmentPath;
+}
+
+std::shared_ptr<sf::Texture> ResourceCache::GetTexture(const std::string& path)
+{
+	return Get<sf::Texture>(textures, path, [path](sf::Texture& t) { return t.loadFromFile(path); });
+}
+
+std::shared_ptr<sf::Shader> ResourceCache::GetShader(const std::string& path, sf::Shader::Type type)
+{
+	return Get<sf::Shader>(shaders, ShaderKey(path, type), [path, type](sf::Shader& s) { return s.loadFromFile(path, type); });
+}
+
+std::shared_ptr<sf::Shader> ResourceCache::GetShader(const std::string& vertexPath, const std::string& geometryPath, const std::string& fragmentPath)
+{
+	return Get<sf::Shader>(shaders, ShaderKey(vertexPath, geometryPath, fragmentPath),
+		[vertexPath, geometryPath, fragmentPath](sf::Shader& s) { return s.loadFromFile(vertexPath, geometryPath, fragmentPath); });
+}
+
+std::shared_ptr<sf::Font> ResourceCache::GetFont(const std::string& path)
+{
+	return Get<sf::Font>(fonts, path, [path](sf::Font& f) { return f.loadFromFile(path); });
+}
+
+std::shared_ptr<sf::SoundBuffer> ResourceCache::GetSoundBuffer(const std::string& path)
+{
+	return Get<sf::SoundBuffer>(soundBuffers, path, [path](sf::SoundBuffer& sb) { return sb.loadFromFile(path); });
+}
+
+std::shared_ptr<sf::Music> ResourceCache::GetMusic(const std::string& path)
+{
+	return Get<sf::Music>(music, path, [path](sf::Music& m) { return m.openFromFile(path); });
+}
+
+void ResourceCache::PreloadTexture(const std::string& path)
+{
+	Preload<sf::Texture>(textures, path, [path](sf::Texture& t) { return t.loadFromFile(path); });
+}
+
+void ResourceCache::PreloadShader(const std::string& path, sf::Shader::Type type)
+{
+	Preload<sf::Shader>(shaders, ShaderKey(path, type), [path, type](sf::Shader& s) { return s.loadFromFile(path, type); });
+}
+
+void ResourceCache::PreloadShader(const std::string& vertexPath, const std::string& geometryPath, const std::string& fragmentPath)
+{
+	Preload<sf::Shader>(shaders, ShaderKey(vertexPath, geometryPath, fragmentPath),
+		[vertexPath, geometryPath, fragmentPath](sf::Shader& s) { return s.loadFromFile(vertexPath, geometryPath, fragmentPath); });
+}
+
+void ResourceCache::PreloadFont(const std::string& path)
+{
+	Preload<sf::Font>(fonts, path, [path](sf::Font& f) { return f.loadFromFile(path); });
+}
+
+void ResourceCache::PreloadSoundBuffer(const std::string& path)
+{
+	Preload<sf::SoundBuffer>(soundBuffers, path, [path](sf::SoundBuffer& sb) { return sb.loadFromFile(path); });
+}
+
+void ResourceCache::PreloadMusic(const std::string& path)
+{
+	Preload<sf::Music>(music, path, [path](sf::Music& m) { return m.openFromFile(path); });
+}
+
+void ResourceCache::WaitForPreloads()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	changed.wait(lock, [] { return toLoad.empty() && !loading; });
+}
+
+void ResourceCache::Purge()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	Purge(textures);
+	Purge(shaders);
+	Purge(fonts);
+	Purge(soundBuffers);
+	Purge(music);
+}
+
+void ResourceCache::Clear()
+{
+	WaitForPreloads();
+
+	if (loader.joinable()) loader.join();
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	textures.clear();
+	shaders.clear();
+	fonts.clear();
+	soundBuffers.clear();
+	music.clear();
+}
+
+template <class T>
+std::shared_ptr<T> ResourceCache::Get(Cache<T>& cache, const std::string& key, std::function<bool(T&)> load)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	typename Cache<T>::iterator it = cache.find(key);
+
+	if (it != cache.end())
+	{
+		// holding on to it keeps a purge from dropping it, the entry is looked up again after every wake-up
+		// since the map may have changed in the meantime
+		std::shared_ptr<T> resource = it->second.resource;
+
+		// still being loaded by someone else
+		changed.wait(lock, [&cache, &key]
+		{
+			typename Cache<T>::iterator entry = cache.find(key);
+			return entry == cache.end() || entry->second.ready;
+		});
+
+		return resource;
+	}
+
+	std::cout << "Loading on demand: " << key << std::endl;
+
+	// claim the entry so that nobody else loads it in the meantime
+	Entry<T>& entry = cache[key];
+	entry.resource = std::make_shared<T>();
+	entry.ready = false;
+
+	std::shared_ptr<T> resource = entry.resource;
+
+	lock.unlock();
+	if (!load(*resource)) std::cerr << "Failed to load: " << key << std::endl;
+	lock.lock();
+
+	cache[key].ready = true;
+	changed.notify_all();
+
+	return resource;
+}
+
+template <class T>
+void ResourceCache::Preload(Cache<T>& cache, const std::string& key, std::function<bool(T&)> load)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (cache.count(key)) return;
+
+	Entry<T>& entry = cache[key];
+	entry.resource = std::make_shared<T>();
+	entry.ready = false;
+
+	std::shared_ptr<T> resource = entry.resource;
+
+	toLoad.push_back([&cache, key, load, resource]
+	{
+		if (!load(*resource)) std::cerr << "Failed to preload: " << key << std::endl;
+
+		std::lock_guard<std::mutex> lock(mutex);
+
+		cache[key].ready = true;
+	});
+
+	// the loader thread quits once it runs out of work, start a new one if needed
+	if (!loading)
+	{
+		if (loader.joinable()) loader.join();
+
+		loading = true;
+		loader = std::thread(&ResourceCache::LoaderThread);
+	}
+}
+
+template <class T>
+void ResourceCache::Purge(Cache<T>& cache)
+{
+	for (typename Cache<T>::iterator it = cache.begin(); it != cache.end();)
+	{
+		if (it->second.ready && it->second.resource.use_count() == 1) it = cache.erase(it);
+		else ++it;
+	}
+}
+
+void ResourceCache::LoaderThread()
+{
+	// textures and shaders need an OpenGL context of their own on this thread
+	sf::Context context;
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (!toLoad.empty())
+	{
+		std::function<void()> job = toLoad.front();
+		toLoad.pop_front();
+
+		lock.unlock();
+		job();
+		lock.lock();
+
+		changed.notify_all();
+	}
+
+	loading = false;
+	changed.notify_all();
+}
@@ -0,0 +1,78 @@
+#ifndef RESOURCECACHE_H
+#define RESOURCECACHE_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+
+/**
+ * Resources shared by path. Whoever holds a handle keeps the resource alive,
+ * the cache keeps its own handle until it gets purged or cleared.
+ */
+class ResourceCache
+{
+public:
+	static std::shared_ptr<sf::Texture> GetTexture(const std::string& path);
+	static std::shared_ptr<sf::Shader> GetShader(const std::string& path, sf::Shader::Type type);
+	static std::shared_ptr<sf::Shader> GetShader(const std::string& vertexPath, const std::string& geometryPath, const std::string& fragmentPath);
+	static std::shared_ptr<sf::Font> GetFont(const std::string& path);
+	static std::shared_ptr<sf::SoundBuffer> GetSoundBuffer(const std::string& path);
+	static std::shared_ptr<sf::Music> GetMusic(const std::string& path);
+
+	// Loads on the background thread, getting a resource that is still loading waits for it
+	static void PreloadTexture(const std::string& path);
+	static void PreloadShader(const std::string& path, sf::Shader::Type type);
+	static void PreloadShader(const std::string& vertexPath, const std::string& geometryPath, const std::string& fragmentPath);
+	static void PreloadFont(const std::string& path);
+	static void PreloadSoundBuffer(const std::string& path);
+	static void PreloadMusic(const std::string& path);
+
+	static void WaitForPreloads();
+
+	// Drops the resources that nobody else holds anymore
+	static void Purge();
+	// Stops the background thread and drops every resource, to be done before the window goes away
+	static void Clear();
+
+private:
+	template <class T>
+	struct Entry
+	{
+		std::shared_ptr<T> resource;
+		bool ready;
+	};
+
+	template <class T>
+	using Cache = std::map<std::string, Entry<T>>;
+
+	template <class T>
+	static std::shared_ptr<T> Get(Cache<T>& cache, const std::string& key, std::function<bool(T&)> load);
+	template <class T>
+	static void Preload(Cache<T>& cache, const std::string& key, std::function<bool(T&)> load);
+	template <class T>
+	static void Purge(Cache<T>& cache);
+
+	static void LoaderThread();
+
+	static std::mutex mutex;
+	static std::condition_variable changed;
+
+	static Cache<sf::Texture> textures;
+	static Cache<sf::Shader> shaders;
+	static Cache<sf::Font> fonts;
+	static Cache<sf::SoundBuffer> soundBuffers;
+	static Cache<sf::Music> music;
+
+	static std::deque<std::function<void()>> toLoad;
+	static std::thread loader;
+	static bool loading;
+};
+
+#endif // RESOURCECACHE_H
@@ -6,6 +6,19 @@
  * @revisions  2015-04-05
  *             Game objects now have custom children drawing support.
  *
+ *             October 18, 2026
+ *             Game objects out of view don't get drawn.
+ *
+ *             October 18, 2026
+ *             Transforms are cached, and only recomputed once they (or their parents') have changed.
+ *
+ *             October 18, 2026
+ *             The hierarchy lives in a flattened SceneGraph, game objects are a facade over their place in it.
+ *             Custom children drawing is gone, the scene graph is drawn in a single sweep.
+ *
+ *             October 18, 2026
+ *             Game objects can be drawn on a layer above the rest of their scene graph.
+ *
  * @designer   Melvin Loho
  *
  * @programmer Melvin Loho
@@ -21,22 +34,42 @@
 
 id_go BGO::ID_GO = 0;
 
+const sf::FloatRect BGO::NO_BOUNDS(0.f, 0.f, -1.f, -1.f);
+
 /**
  * Constructor.
  */
 BGO::BGO() :
-m_parent(nullptr),
+BGO(SceneGraph::OBJECT)
+{}
+
+/**
+ * Constructor.
+ * Also sets the kind of component this game object is pooled as in its scene graph.
+ */
+BGO::BGO(SceneGraph::Component component) :
+m_graph(&m_ownGraph),
+m_index(0),
+m_component(component),
 m_id(++ID_GO),
-m_ignoringChildren(false)
+m_layer(0)
 {
+	m_ownGraph.reset(*this);
+
 	//std::cout << "Constructed: " << "GO" << "[" << getID() << "]" << std::endl;
 }
 
 /**
  * Virtual Destructor.
+ * Leaves the scene graph, the children are left on their own.
  */
 BGO::~BGO()
 {
+	m_graph->detach(m_index);
+
+	// the first child is always right behind its parent
+	while (m_ownGraph.size() > 1) m_ownGraph.detach(1);
+
 	//std::cout << "Destructed: " << "GO" << "[" << getID() << "]" << std::endl;
 }
 
@@ -63,7 +96,8 @@ id_go BGO::getID() const
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Gathered from the scene graph, hopping from one child's subtree to the next.
  *
  * @designer   Melvin Loho
  *
@@ -71,9 +105,18 @@ id_go BGO::getID() const
  *
  * @return     The vector of children
  */
-const std::vector<BGO*>& BGO::getChildren() const
+std::vector<BGO*> BGO::getChildren() const
 {
-	return m_children;
+	std::vector<BGO*> children;
+
+	const SceneGraph::Index end = m_graph->getEnd(m_index);
+
+	for (SceneGraph::Index i = m_index + 1; i < end; i = m_graph->getEnd(i))
+	{
+		children.push_back(m_graph->getNode(i));
+	}
+
+	return children;
 }
 
 /**
@@ -91,7 +134,9 @@ const std::vector<BGO*>& BGO::getChildren() const
  */
 BGO* BGO::getParent() const
 {
-	return m_parent;
+	const SceneGraph::Index parent = m_graph->getParent(m_index);
+
+	return parent == SceneGraph::NONE ? nullptr : m_graph->getNode(parent);
 }
 
 /**
@@ -100,7 +145,11 @@ BGO* BGO::getParent() const
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             The added game object's global transform is updated to follow its new parent.
+ *
+ *             October 18, 2026
+ *             The added game object (along with its children) moves into this one's scene graph.
  *
  * @designer   Melvin Loho
  *
@@ -114,11 +163,14 @@ void BGO::add(BGO& gO)
 	{
 		throw "Are you crazy!? You've just tried to add a game object to itself!";
 	}
+	else if (m_graph == gO.m_graph && m_graph->contains(gO.m_index, m_index))
+	{
+		throw "Are you crazy!? You've just tried to add a game object to one of its own children!";
+	}
 	else
 	{
-		if (gO.m_parent) gO.m_parent->rem(gO);
-		gO.m_parent = this;
-		m_children.push_back(&gO);
+		gO.m_graph->detach(gO.m_index);
+		m_graph->attach(m_index, gO.m_ownGraph);
 	}
 }
 
@@ -127,7 +179,12 @@ void BGO::add(BGO& gO)
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             The removed game object no longer has a parent.
+ *
+ *             October 18, 2026
+ *             Found through its place in the scene graph instead of by searching,
+ *             the removed game object (along with its children) moves back into its own scene graph.
  *
  * @designer   Melvin Loho
  *
@@ -139,17 +196,10 @@ void BGO::add(BGO& gO)
  */
 bool BGO::rem(const BGO& gO)
 {
-	for (std::vector<BGO*>::iterator iter = m_children.begin();
-		iter != m_children.end();
-		++iter)
-	{
-		if (*iter == &gO)
-		{
-			m_children.erase(iter);
-			return true;
-		}
-	}
-	return false;
+	if (gO.m_graph != m_graph || m_graph->getParent(gO.m_index) != m_index) return false;
+
+	m_graph->detach(gO.m_index);
+	return true;
 }
 
 /**
@@ -157,7 +207,11 @@ bool BGO::rem(const BGO& gO)
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             The removed game object no longer has a parent.
+ *
+ *             October 18, 2026
+ *             Only this game object's children are looked at, not their children.
  *
  * @designer   Melvin Loho
  *
@@ -169,13 +223,13 @@ bool BGO::rem(const BGO& gO)
  */
 bool BGO::rem(id_go id)
 {
-	for (std::vector<BGO*>::iterator iter = m_children.begin();
-		iter != m_children.end();
-		++iter)
+	const SceneGraph::Index end = m_graph->getEnd(m_index);
+
+	for (SceneGraph::Index i = m_index + 1; i < end; i = m_graph->getEnd(i))
 	{
-		if ((*iter)->m_id == id)
+		if (m_graph->getNode(i)->m_id == id)
 		{
-			m_children.erase(iter);
+			m_graph->detach(i);
 			return true;
 		}
 	}
@@ -197,7 +251,7 @@ bool BGO::rem(id_go id)
  */
 bool BGO::hasChildren() const
 {
-	if (m_ignoringChildren || m_children.empty()) return false;
+	if (m_graph->isIgnoringChildren(m_index) || m_graph->getEnd(m_index) == m_index + 1) return false;
 	else return true;
 }
 
@@ -216,7 +270,7 @@ bool BGO::hasChildren() const
  */
 void BGO::ignoreChildren(bool arg)
 {
-	m_ignoringChildren = arg;
+	m_graph->setIgnoringChildren(m_index, arg);
 }
 
 /**
@@ -224,7 +278,8 @@ void BGO::ignoreChildren(bool arg)
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Cached, only recomputed after the transform has been invalidated.
  *
  * @designer   Melvin Loho
  *
@@ -232,9 +287,9 @@ void BGO::ignoreChildren(bool arg)
  *
  * @return     The local transform
  */
-sf::Transform BGO::getLocalTransform() const
+const sf::Transform& BGO::getLocalTransform() const
 {
-	return sf::Transform::Identity;
+	return m_graph->getLocalTransform(m_index);
 }
 
 /**
@@ -243,7 +298,9 @@ sf::Transform BGO::getLocalTransform() const
  *
  * @date       2015-04-03
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Kept up to date by updateSG() and updateTransforms() instead of by drawing,
+ *             relative to the root of the scene graph.
  *
  * @designer   Melvin Loho
  *
@@ -253,7 +310,119 @@ sf::Transform BGO::getLocalTransform() const
  */
 const sf::Transform& BGO::getGlobalTransform() const
 {
-	return m_globaltrans;
+	return m_graph->getGlobalTransform(m_index);
+}
+
+/**
+ * Brings the global transforms of this game object and its children up to date,
+ * for game objects that aren't updated through updateSG().
+ * Only the game objects that (or whose parents) have changed get their transforms recomputed.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions  October 18, 2026
+ *             A sweep over the scene graph.
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ */
+void BGO::updateTransforms()
+{
+	m_graph->updateTransforms(m_index);
+}
+
+/**
+ * Sets how many renderer layers above the rest of its scene graph this game object is drawn,
+ * e.g. for it not to split up the batches of what is drawn before and after it.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      layer The layers above
+ */
+void BGO::setLayer(sf::Uint8 layer)
+{
+	m_layer = layer;
+}
+
+/**
+ * Gets how many renderer layers above the rest of its scene graph this game object is drawn.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @return     The layers above
+ */
+sf::Uint8 BGO::getLayer() const
+{
+	return m_layer;
+}
+
+/**
+ * Gets the game objects of one kind in the whole scene graph that this game object is part of.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      component The kind of game objects
+ *
+ * @return     The game objects, in drawing order
+ */
+const std::vector<BGO*>& BGO::getComponents(SceneGraph::Component component) const
+{
+	return m_graph->getComponents(component);
+}
+
+/**
+ * Marks the local transform of this game object as out of date,
+ * to be recomputed (along with the global transforms below it) when next needed.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ */
+void BGO::invalidateTransform()
+{
+	m_graph->invalidateTransform(m_index);
+}
+
+/**
+ * Computes the transformations of this game object.
+ * Only called after the transform has been invalidated.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @return     The local transform, the identity by default
+ */
+sf::Transform BGO::computeLocalTransform() const
+{
+	return sf::Transform::Identity;
 }
 
 /**
@@ -261,7 +430,11 @@ const sf::Transform& BGO::getGlobalTransform() const
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             The global transforms are brought up to date along the way.
+ *
+ *             October 18, 2026
+ *             A sweep over the scene graph.
  *
  * @designer   Melvin Loho
  *
@@ -271,15 +444,7 @@ const sf::Transform& BGO::getGlobalTransform() const
  */
 void BGO::updateSG(const sf::Time& t)
 {
-	update(t);
-
-	if (hasChildren())
-	{
-		for (BGO* bgo : m_children)
-		{
-			bgo->updateSG(t);
-		}
-	}
+	m_graph->update(m_index, t);
 }
 
 /**
@@ -311,6 +476,16 @@ void BGO::update(const sf::Time& t)
  *             This method now supports the overridable drawChildren() method
  *             in addition to the already available overridable draw() method
  *
+ *             October 18, 2026
+ *             Game objects out of the renderer's view are skipped (their children are not)
+ *
+ *             October 18, 2026
+ *             The global transform is no longer cached here, see updateTransforms()
+ *
+ *             October 18, 2026
+ *             A sweep over the scene graph, every game object is drawn with its parent's global transform
+ *             on top of the render states (drawChildren() is gone)
+ *
  * @designer   Melvin Loho
  *
  * @programmer Melvin Loho
@@ -320,23 +495,14 @@ void BGO::update(const sf::Time& t)
  */
 void BGO::drawSceneGraph(Renderer& renderer, sf::RenderStates states) const
 {
-	// Draw self
-	draw(renderer, states);
-
-	// Combine transforms (caller's + mine)
-	states.transform *= getLocalTransform();
-
-	// cache global transform
-	m_globaltrans = states.transform;
-
-	// Draw children
-	if (!m_ignoringChildren) drawChildren(renderer, states);
+	m_graph->draw(m_index, renderer, states);
 }
 
 /**
- * Draws this game object's children.
+ * Gets the bounds of what this game object draws, in the space of the render states it draws with.
+ * Game objects that don't draw anything (or don't know what they cover) are never culled.
  *
- * @date       2015-04-05
+ * @date       October 18, 2026
  *
  * @revisions
  *
@@ -344,17 +510,11 @@ void BGO::drawSceneGraph(Renderer& renderer, sf::RenderStates states) const
  *
  * @programmer Melvin Loho
  *
- * @param      renderer The renderer
- * @param      states   The render states
+ * @return     The bounds, NO_BOUNDS by default
  */
-void BGO::drawChildren(Renderer& renderer, sf::RenderStates states) const
+sf::FloatRect BGO::getBounds() const
 {
-	if (m_children.empty()) return;
-
-	for (const BGO* bgo : m_children)
-	{
-		bgo->drawSceneGraph(renderer, states);
-	}
+	return NO_BOUNDS;
 }
 
 /**
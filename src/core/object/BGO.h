@@ -3,6 +3,7 @@
 
 #include <SFML/Graphics.hpp>
 #include <vector>
+#include "SceneGraph.h"
 
 class Renderer;
 
@@ -11,11 +12,17 @@ typedef unsigned int id_go;
 class BGO
 {
 public:
+	// Bounds of something that is never culled
+	static const sf::FloatRect NO_BOUNDS;
+
 	BGO();
 	virtual ~BGO();
 
+	BGO(const BGO&) = delete;
+	BGO& operator=(const BGO&) = delete;
+
 	id_go getID() const;
-	const std::vector<BGO*>& getChildren() const;
+	std::vector<BGO*> getChildren() const;
 	BGO* getParent() const;
 
 	void add(BGO& gO);
@@ -25,28 +32,50 @@ public:
 	bool hasChildren() const;
 	void ignoreChildren(bool arg);
 
-	virtual sf::Transform getLocalTransform() const;
+	// Cached, recomputed only once they have changed
+	const sf::Transform& getLocalTransform() const;
+	// As of the last update of the transforms (relative to the root of the scene graph)
 	const sf::Transform& getGlobalTransform() const;
+	// Brings the global transforms of this game object and its children up to date
+	void updateTransforms();
+	// What draw() covers, in the space of the render states it draws with
+	virtual sf::FloatRect getBounds() const;
+
+	// Drawn this many renderer layers above the layer its scene graph is drawn on (its children aren't)
+	void setLayer(sf::Uint8 layer);
+	sf::Uint8 getLayer() const;
+
+	// The game objects of one kind in the whole scene graph that this one is part of, in drawing order
+	const std::vector<BGO*>& getComponents(SceneGraph::Component component) const;
 
 	void updateSG(const sf::Time& t);
 	virtual void update(const sf::Time& t);
 
 protected:
 	friend class Renderer;
+	friend class SceneGraph;
+
+	explicit BGO(SceneGraph::Component component);
+
+	// To be called whenever whatever computeLocalTransform() depends on changes
+	void invalidateTransform();
+	virtual sf::Transform computeLocalTransform() const;
 
 	void drawSceneGraph(Renderer& renderer, sf::RenderStates states) const;
-	virtual void drawChildren(Renderer& renderer, sf::RenderStates states) const;
 	virtual void draw(Renderer& renderer, sf::RenderStates states) const;
 
 private:
 	static id_go ID_GO;
 
-	std::vector<BGO*> m_children;
-	BGO* m_parent;
-	id_go m_id;
-	bool m_ignoringChildren;
+	// The graph of which this game object is the root, empty while it has a parent
+	SceneGraph m_ownGraph;
+	// The graph it is in, and where
+	SceneGraph* m_graph;
+	SceneGraph::Index m_index;
 
-	mutable sf::Transform m_globaltrans;
+	const SceneGraph::Component m_component;
+	id_go m_id;
+	sf::Uint8 m_layer;
 };
 
 #endif // BGO_H
@@ -0,0 +1,40 @@
+/**
+ * Glyphs shared by the texts.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @notes      sf::Font loads a glyph into its page texture the first time it's asked for it, and once a page is full
+ *             it replaces the texture with a bigger one. The texts are laid out on the main thread while the render thread
+ *             may be drawing with that texture, so every glyph they use is loaded up front and they never ask for another.
+ */
+
+#include "Glyph.h"
+
+#include <mutex>
+#include <set>
+#include <utility>
+
+static std::mutex mutexPrepared;
+static std::set<std::pair<const sf::Font*, unsigned int>> prepared;
+
+void PrepareGlyphs(const sf::Font& font, unsigned int characterSize)
+{
+	for (sf::Uint32 c = 0x20; c < 0x7F; ++c) font.getGlyph(c, characterSize, false);
+
+	std::lock_guard<std::mutex> lock(mutexPrepared);
+
+	prepared.insert(std::make_pair(&font, characterSize));
+}
+
+bool AreGlyphsPrepared(const sf::Font& font, unsigned int characterSize)
+{
+	std::lock_guard<std::mutex> lock(mutexPrepared);
+
+	return prepared.find(std::make_pair(&font, characterSize)) != prepared.end();
+}
@@ -0,0 +1,43 @@
+#ifndef GLYPH_H
+#define GLYPH_H
+
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+// Loads the glyphs of the printable ASCII characters of a font at a size into the font's texture.
+// A glyph loaded for the first time updates that texture (and a full page gets swapped for a bigger texture),
+// so this is done where nothing can be drawing with the font: before the render thread starts, or on it.
+void PrepareGlyphs(const sf::Font& font, unsigned int characterSize);
+// Texts only ever look up the glyphs of a prepared size, which are never loaded again
+bool AreGlyphsPrepared(const sf::Font& font, unsigned int characterSize);
+
+// The character whose prepared glyph stands in for this one ('?' for anything that wasn't prepared)
+static inline sf::Uint32 PreparedCharacter(sf::Uint32 c)
+{
+	return (c >= 0x20 && c < 0x7F) ? c : L'?';
+}
+
+// The two triangles of a glyph whose baseline starts at (x, y), same as sf::Text with a pixel of padding around them
+static inline void AddGlyph(std::vector<sf::Vertex>& vertices, float x, float y, const sf::Color& color, const sf::Glyph& glyph)
+{
+	const float padding = 1.f;
+
+	const float left = glyph.bounds.left - padding;
+	const float top = glyph.bounds.top - padding;
+	const float right = glyph.bounds.left + glyph.bounds.width + padding;
+	const float bottom = glyph.bounds.top + glyph.bounds.height + padding;
+
+	const float u1 = static_cast<float>(glyph.textureRect.left) - padding;
+	const float v1 = static_cast<float>(glyph.textureRect.top) - padding;
+	const float u2 = static_cast<float>(glyph.textureRect.left + glyph.textureRect.width) + padding;
+	const float v2 = static_cast<float>(glyph.textureRect.top + glyph.textureRect.height) + padding;
+
+	vertices.push_back(sf::Vertex(sf::Vector2f(x + left, y + top), color, sf::Vector2f(u1, v1)));
+	vertices.push_back(sf::Vertex(sf::Vector2f(x + right, y + top), color, sf::Vector2f(u2, v1)));
+	vertices.push_back(sf::Vertex(sf::Vector2f(x + left, y + bottom), color, sf::Vector2f(u1, v2)));
+	vertices.push_back(sf::Vertex(sf::Vector2f(x + left, y + bottom), color, sf::Vector2f(u1, v2)));
+	vertices.push_back(sf::Vertex(sf::Vector2f(x + right, y + top), color, sf::Vector2f(u2, v1)));
+	vertices.push_back(sf::Vertex(sf::Vector2f(x + right, y + bottom), color, sf::Vector2f(u2, v2)));
+}
+
+#endif // GLYPH_H
@@ -0,0 +1,475 @@
+/**
+ * HUD Game Object.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions  October 18, 2026
+ *             Only uses the glyphs prepared ahead of time, looking up a new one could change the font's texture mid-draw.
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @notes      A BGO that represents a text made of fields, for HUDs that mostly stay the same.
+ *             Each field keeps the glyphs it was laid out with, only the fields whose values change get laid out again.
+ *             The glyphs are drawn as vertex ranges with the font's texture, batched like everything else.
+ *             Fields follow one another like the pieces of a single string would, moving a field doesn't rebuild it.
+ */
+
+#include "HGO.h"
+#include "Glyph.h"
+
+#include "../Renderer.h"
+
+#include <algorithm>
+#include <cstdio>
+
+/**
+ * Constructor.
+ */
+HGO::HGO() :
+BGO(SceneGraph::TEXT),
+m_font(nullptr),
+m_characterSize(30),
+m_color(sf::Color::White)
+{}
+
+/**
+ * Constructor.
+ * Also sets the font and the character size.
+ */
+HGO::HGO(const sf::Font& font, unsigned int characterSize) :
+BGO(SceneGraph::TEXT),
+m_font(&font),
+m_characterSize(characterSize),
+m_color(sf::Color::White)
+{}
+
+/**
+ * Destructor.
+ */
+HGO::~HGO()
+{}
+
+/**
+ * Sets the font of every field.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      font The font
+ */
+void HGO::setFont(const sf::Font& font)
+{
+	m_font = &font;
+
+	for (FieldData& field : m_fields) build(field);
+	layout();
+}
+
+/**
+ * Sets the character size of every field.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      characterSize The character size, in pixels
+ */
+void HGO::setCharacterSize(unsigned int characterSize)
+{
+	m_characterSize = characterSize;
+
+	for (FieldData& field : m_fields) build(field);
+	layout();
+}
+
+/**
+ * Sets the colour of every field.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      color The colour
+ */
+void HGO::setColor(const sf::Color& color)
+{
+	m_color = color;
+
+	for (FieldData& field : m_fields)
+	{
+		for (sf::Vertex& vertex : field.vertices) vertex.color = color;
+	}
+}
+
+/**
+ * Sets the position of the top left corner of the text.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      position The position
+ */
+void HGO::setPosition(const sf::Vector2f& position)
+{
+	m_position = position;
+
+	invalidateTransform();
+}
+
+/**
+ * Appends a field to the text.
+ * Static parts of the text are fields that never get another value.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      string What the field shows
+ *
+ * @return     The field
+ */
+HGO::Field HGO::add(const sf::String& string)
+{
+	FieldData field;
+
+	field.string = string;
+	field.isNumber = false;
+	field.number = 0.0;
+	field.decimals = 0;
+
+	m_fields.push_back(field);
+
+	build(m_fields.back());
+	layout();
+
+	return getFieldCount() - 1;
+}
+
+/**
+ * Removes the specified field and every one after it.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      first The first field to remove
+ */
+void HGO::removeFields(Field first)
+{
+	if (first >= getFieldCount()) return;
+
+	m_fields.erase(m_fields.begin() + first, m_fields.end());
+
+	layout();
+}
+
+/**
+ * Sets what a field shows.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      field The field
+ * @param      value What it shows
+ */
+void HGO::setValue(Field field, const sf::String& value)
+{
+	FieldData& data = m_fields[field];
+
+	if (!data.isNumber && data.string == value) return;
+
+	data.string = value;
+	data.isNumber = false;
+
+	rebuild(field);
+}
+
+/**
+ * Sets the number a field shows.
+ * Nothing gets formatted unless the number differs from the one shown.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      field    The field
+ * @param      value    The number it shows
+ * @param      decimals How many digits it shows after the decimal point
+ */
+void HGO::setValue(Field field, double value, unsigned int decimals)
+{
+	FieldData& data = m_fields[field];
+
+	if (data.isNumber && data.number == value && data.decimals == decimals) return;
+
+	char buffer[32];
+	std::snprintf(buffer, sizeof(buffer), "%.*f", static_cast<int>(decimals), value);
+
+	data.string = buffer;
+	data.isNumber = true;
+	data.number = value;
+	data.decimals = decimals;
+
+	rebuild(field);
+}
+
+/**
+ * Gets the bounds of the text.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @return     The bounds, transformed by the local transformation
+ */
+sf::FloatRect HGO::getBounds() const
+{
+	return getLocalTransform().transformRect(m_bounds);
+}
+
+/**
+ * Gets the local transformation matrix of the text.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @return     The transformation matrix
+ */
+sf::Transform HGO::computeLocalTransform() const
+{
+	return sf::Transform().translate(m_position);
+}
+
+/**
+ * Lays the glyphs of a field out, the way sf::Text would.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      field The field
+ */
+void HGO::build(FieldData& field)
+{
+	field.vertices.clear();
+	field.split = 0;
+	field.lines = 0;
+	field.firstWidth = field.restWidth = field.endX = 0.f;
+
+	if (!m_font) return;
+
+	if (!AreGlyphsPrepared(*m_font, m_characterSize)) throw "The glyphs of this character size were not prepared!!";
+
+	const float whitespace = m_font->getGlyph(L' ', m_characterSize, false).advance;
+	const float lineSpacing = m_font->getLineSpacing(m_characterSize);
+
+	float x = 0.f;
+	float y = static_cast<float>(m_characterSize);
+	sf::Uint32 previous = 0;
+
+	for (sf::Uint32 c : field.string)
+	{
+		switch (c)
+		{
+		case L'\t':
+			x += whitespace * 4;
+			previous = 0;
+			continue;
+
+		case L'\n':
+			if (field.lines == 0)
+			{
+				field.split = field.vertices.size();
+				field.firstWidth = x;
+			}
+			else field.restWidth = std::max(field.restWidth, x);
+
+			++field.lines;
+			x = 0.f;
+			y += lineSpacing;
+			previous = 0;
+			continue;
+		}
+
+		// anything without a prepared glyph shows up as its stand-in, kerning included
+		c = PreparedCharacter(c);
+
+		x += m_font->getKerning(previous, c, m_characterSize);
+		previous = c;
+
+		if (c == L' ')
+		{
+			x += whitespace;
+			continue;
+		}
+
+		const sf::Glyph& glyph = m_font->getGlyph(c, m_characterSize, false);
+
+		AddGlyph(field.vertices, x, y, m_color, glyph);
+
+		x += glyph.advance;
+	}
+
+	if (field.lines == 0)
+	{
+		field.split = field.vertices.size();
+		field.firstWidth = x;
+	}
+	else field.restWidth = std::max(field.restWidth, x);
+
+	field.endX = x;
+}
+
+/**
+ * Lays a field out again, and the fields after it too if it now ends somewhere else.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      field The field
+ */
+void HGO::rebuild(Field field)
+{
+	FieldData& data = m_fields[field];
+
+	const float endX = data.endX;
+	const unsigned int lines = data.lines;
+	const float width = std::max(data.firstWidth, data.restWidth);
+
+	build(data);
+
+	if (data.endX != endX || data.lines != lines || std::max(data.firstWidth, data.restWidth) != width) layout();
+}
+
+/**
+ * Places every field where the one before it ends, and measures the text.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ */
+void HGO::layout()
+{
+	const float lineSpacing = m_font ? m_font->getLineSpacing(m_characterSize) : 0.f;
+
+	sf::Vector2f pen;
+	float width = 0.f;
+
+	for (FieldData& field : m_fields)
+	{
+		field.start = pen;
+
+		if (field.lines == 0)
+		{
+			pen.x += field.endX;
+		}
+		else
+		{
+			width = std::max(width, std::max(pen.x + field.firstWidth, field.restWidth));
+
+			pen.x = field.endX;
+			pen.y += field.lines * lineSpacing;
+		}
+
+		width = std::max(width, pen.x);
+	}
+
+	m_bounds = sf::FloatRect(0.f, 0.f, width, pen.y + lineSpacing);
+}
+
+/**
+ * Draws the fields, as vertex ranges that batch together.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @param      renderer The renderer
+ * @param      states   The render states
+ */
+void HGO::draw(Renderer& renderer, sf::RenderStates states) const
+{
+	if (!m_font) return;
+
+	states.transform.combine(getLocalTransform());
+	states.texture = &m_font->getTexture(m_characterSize);
+
+	for (const FieldData& field : m_fields)
+	{
+		sf::RenderStates fieldStates = states;
+
+		fieldStates.transform.translate(field.start);
+		renderer.draw(field.vertices.data(), field.split, sf::PrimitiveType::Triangles, fieldStates);
+
+		if (field.lines > 0)
+		{
+			fieldStates = states;
+
+			fieldStates.transform.translate(0.f, field.start.y);
+			renderer.draw(field.vertices.data() + field.split, field.vertices.size() - field.split, sf::PrimitiveType::Triangles, fieldStates);
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#ifndef HGO_H
+#define HGO_H
+
+#include "BGO.h"
+
+class Renderer;
+
+class HGO : public BGO
+{
+public:
+	typedef unsigned int Field;
+
+	HGO();
+	HGO(const sf::Font& font, unsigned int characterSize = 30);
+
+	virtual ~HGO();
+
+	void setFont(const sf::Font& font);
+	void setCharacterSize(unsigned int characterSize);
+	void setColor(const sf::Color& color);
+	void setPosition(const sf::Vector2f& position);
+
+	// Appends a field, which carries on from where the one before it ends
+	Field add(const sf::String& string = "");
+	// Removes the specified field and every one after it
+	void removeFields(Field first);
+	inline Field getFieldCount() const { return static_cast<Field>(m_fields.size()); }
+
+	// Only rebuilds the field when the value differs from what it shows
+	void setValue(Field field, const sf::String& value);
+	void setValue(Field field, double value, unsigned int decimals = 0);
+
+	sf::FloatRect getBounds() const override;
+
+protected:
+	sf::Transform computeLocalTransform() const override;
+	void draw(Renderer& renderer, sf::RenderStates states) const override;
+
+private:
+	struct FieldData
+	{
+		sf::String string;
+		bool isNumber;
+		double number;
+		unsigned int decimals;
+
+		// the glyphs of the first line are relative to where the field starts,
+		// the glyphs of the lines after it (from split onwards) to the start of their line
+		std::vector<sf::Vertex> vertices;
+		unsigned int split, lines;
+		float firstWidth, restWidth, endX;
+
+		sf::Vector2f start;
+	};
+
+	void build(FieldData& field);
+	void rebuild(Field field);
+	void layout();
+
+	std::vector<FieldData> m_fields;
+
+	const sf::Font* m_font;
+	unsigned int m_characterSize;
+	sf::Color m_color;
+	sf::Vector2f m_position;
+
+	sf::FloatRect m_bounds;
+};
+
+#endif // HGO_H
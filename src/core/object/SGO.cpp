@@ -3,7 +3,14 @@
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Has bounds, to be culled when out of view.
+ *
+ *             October 18, 2026
+ *             The transform is only recomputed once the sprite has been changed.
+ *
+ *             October 18, 2026
+ *             Pooled with the other sprites of its scene graph.
  *
  * @designer   Melvin Loho
  *
@@ -20,14 +27,16 @@
 /**
  * Constructor.
  */
-SGO::SGO()
+SGO::SGO() :
+BGO(SceneGraph::SPRITE)
 {}
 
 /**
  * Constructor.
  * Also sets the texture of the sprite.
  */
-SGO::SGO(const sf::Texture& texture)
+SGO::SGO(const sf::Texture& texture) :
+BGO(SceneGraph::SPRITE)
 {
 	data.setTexture(texture);
 }
@@ -36,7 +45,8 @@ SGO::SGO(const sf::Texture& texture)
  * Constructor.
  * Also sets the texture of the sprite and the sub rectangle that the sprite should display.
  */
-SGO::SGO(const sf::Texture& texture, const sf::IntRect& rect)
+SGO::SGO(const sf::Texture& texture, const sf::IntRect& rect) :
+BGO(SceneGraph::SPRITE)
 {
 	data.setTexture(texture);
 	data.setTextureRect(rect);
@@ -53,7 +63,8 @@ SGO::~SGO()
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Invalidates the cached transform.
  *
  * @designer   Melvin Loho
  *
@@ -63,6 +74,9 @@ SGO::~SGO()
  */
 sf::Sprite& SGO::sprite()
 {
+	// whoever gets to change it might move it
+	invalidateTransform();
+
 	return data;
 }
 
@@ -89,7 +103,8 @@ const sf::Sprite& SGO::sprite() const
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Only called when the cached transform is out of date.
  *
  * @designer   Melvin Loho
  *
@@ -97,11 +112,29 @@ const sf::Sprite& SGO::sprite() const
  *
  * @return     The transformation matrix
  */
-sf::Transform SGO::getLocalTransform() const
+sf::Transform SGO::computeLocalTransform() const
 {
 	return data.getTransform();
 }
 
+/**
+ * Gets the bounds of the sprite represented by this game object.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @return     The bounds, transformed by the local transformation
+ */
+sf::FloatRect SGO::getBounds() const
+{
+	return getLocalTransform().transformRect(data.getLocalBounds());
+}
+
 /**
  * Sets the anchor point to one of the following:
  * > the middle of the sprite
@@ -125,6 +158,8 @@ void SGO::middleAnchorPoint(bool arg)
 		data.setOrigin(bounds.width * 0.5f, bounds.height * 0.5f);
 	}
 	else data.setOrigin(0.f, 0.f);
+
+	invalidateTransform();
 }
 
 /**
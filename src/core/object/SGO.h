@@ -17,11 +17,12 @@ public:
 	sf::Sprite& sprite();
 	const sf::Sprite& sprite() const;
 
-	sf::Transform getLocalTransform() const override;
+	sf::FloatRect getBounds() const override;
 
 	void middleAnchorPoint(bool arg);
 
 protected:
+	sf::Transform computeLocalTransform() const override;
 	void draw(Renderer& renderer, sf::RenderStates states) const override;
 
 private:
@@ -0,0 +1,250 @@
+/**
+ * The flattened storage of a scene graph.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @notes      The nodes of a tree of game objects are kept in depth-first order, in parallel arrays:
+ *             the game object itself, the index of its parent, the end of its subtree, its transforms and its flags.
+ *             A parent always comes before its children, so the global transforms are brought up to date
+ *             (and the nodes updated and drawn) in a single pass from front to back.
+ *             Moving a subtree between graphs shifts the nodes behind it, each game object knows where it is.
+ *             Nothing is to be added to or removed from a graph while it's being swept.
+ */
+
+#include "SceneGraph.h"
+
+#include "BGO.h"
+#include "../Renderer.h"
+
+const SceneGraph::Index SceneGraph::NONE = static_cast<SceneGraph::Index>(-1);
+
+SceneGraph::SceneGraph() :
+m_componentsDirty(true)
+{}
+
+void SceneGraph::reset(BGO& root)
+{
+	m_nodes.assign(1, &root);
+	m_parents.assign(1, NONE);
+	m_ends.assign(1, 1);
+	m_locals.assign(1, sf::Transform::Identity);
+	m_globals.assign(1, sf::Transform::Identity);
+	m_flags.assign(1, LOCAL_DIRTY | GLOBAL_DIRTY);
+
+	root.m_graph = this;
+	root.m_index = 0;
+
+	m_componentsDirty = true;
+}
+
+void SceneGraph::attach(Index parent, SceneGraph& subtree)
+{
+	const Index pos = m_ends[parent];
+	const Index n = subtree.size();
+
+	// make room behind the last descendant of the parent
+	for (Index i = pos; i < size(); ++i)
+	{
+		if (m_parents[i] >= pos) m_parents[i] += n;
+		m_ends[i] += n;
+		m_nodes[i]->m_index = i + n;
+	}
+
+	for (Index a = parent; a != NONE; a = m_parents[a]) m_ends[a] += n;
+
+	m_nodes.insert(m_nodes.begin() + pos, subtree.m_nodes.begin(), subtree.m_nodes.end());
+	m_parents.insert(m_parents.begin() + pos, subtree.m_parents.begin(), subtree.m_parents.end());
+	m_ends.insert(m_ends.begin() + pos, subtree.m_ends.begin(), subtree.m_ends.end());
+	m_locals.insert(m_locals.begin() + pos, subtree.m_locals.begin(), subtree.m_locals.end());
+	m_globals.insert(m_globals.begin() + pos, subtree.m_globals.begin(), subtree.m_globals.end());
+	m_flags.insert(m_flags.begin() + pos, subtree.m_flags.begin(), subtree.m_flags.end());
+
+	for (Index i = pos; i < pos + n; ++i)
+	{
+		m_parents[i] = i == pos ? parent : m_parents[i] + pos;
+		m_ends[i] += pos;
+		m_nodes[i]->m_graph = this;
+		m_nodes[i]->m_index = i;
+	}
+
+	// the subtree now follows its new parent
+	m_flags[pos] |= GLOBAL_DIRTY;
+
+	subtree.m_nodes.clear();
+	subtree.m_parents.clear();
+	subtree.m_ends.clear();
+	subtree.m_locals.clear();
+	subtree.m_globals.clear();
+	subtree.m_flags.clear();
+
+	subtree.m_componentsDirty = true;
+	m_componentsDirty = true;
+}
+
+void SceneGraph::detach(Index i)
+{
+	// the root of a graph has nowhere else to go
+	if (m_parents[i] == NONE) return;
+
+	SceneGraph& to = m_nodes[i]->m_ownGraph;
+
+	const Index end = m_ends[i];
+	const Index n = end - i;
+
+	to.m_nodes.assign(m_nodes.begin() + i, m_nodes.begin() + end);
+	to.m_parents.assign(m_parents.begin() + i, m_parents.begin() + end);
+	to.m_ends.assign(m_ends.begin() + i, m_ends.begin() + end);
+	to.m_locals.assign(m_locals.begin() + i, m_locals.begin() + end);
+	to.m_globals.assign(m_globals.begin() + i, m_globals.begin() + end);
+	to.m_flags.assign(m_flags.begin() + i, m_flags.begin() + end);
+
+	for (Index k = 0; k < n; ++k)
+	{
+		to.m_parents[k] = k == 0 ? NONE : to.m_parents[k] - i;
+		to.m_ends[k] -= i;
+		to.m_nodes[k]->m_graph = &to;
+		to.m_nodes[k]->m_index = k;
+	}
+
+	// without a parent, the global transform is the local one
+	to.m_flags[0] |= GLOBAL_DIRTY;
+	to.m_componentsDirty = true;
+
+	for (Index a = m_parents[i]; a != NONE; a = m_parents[a]) m_ends[a] -= n;
+
+	m_nodes.erase(m_nodes.begin() + i, m_nodes.begin() + end);
+	m_parents.erase(m_parents.begin() + i, m_parents.begin() + end);
+	m_ends.erase(m_ends.begin() + i, m_ends.begin() + end);
+	m_locals.erase(m_locals.begin() + i, m_locals.begin() + end);
+	m_globals.erase(m_globals.begin() + i, m_globals.begin() + end);
+	m_flags.erase(m_flags.begin() + i, m_flags.begin() + end);
+
+	// close the gap, the parents of the nodes behind it are either before it or behind it too
+	for (Index k = i; k < size(); ++k)
+	{
+		if (m_parents[k] >= end) m_parents[k] -= n;
+		m_ends[k] -= n;
+		m_nodes[k]->m_index = k;
+	}
+
+	m_componentsDirty = true;
+}
+
+bool SceneGraph::isIgnoringChildren(Index i) const
+{
+	return (m_flags[i] & IGNORING_CHILDREN) != 0;
+}
+
+void SceneGraph::setIgnoringChildren(Index i, bool arg)
+{
+	if (arg) m_flags[i] |= IGNORING_CHILDREN;
+	else m_flags[i] &= ~IGNORING_CHILDREN;
+}
+
+const sf::Transform& SceneGraph::getLocalTransform(Index i)
+{
+	if (m_flags[i] & LOCAL_DIRTY)
+	{
+		m_locals[i] = m_nodes[i]->computeLocalTransform();
+		m_flags[i] &= ~LOCAL_DIRTY;
+	}
+
+	return m_locals[i];
+}
+
+void SceneGraph::invalidateTransform(Index i)
+{
+	m_flags[i] |= LOCAL_DIRTY | GLOBAL_DIRTY;
+}
+
+void SceneGraph::updateTransforms(Index begin)
+{
+	const Index end = m_ends[begin];
+
+	for (Index i = begin; i < end; ++i)
+	{
+		updateTransform(i, i != begin && (m_flags[m_parents[i]] & CHANGED));
+	}
+}
+
+void SceneGraph::update(Index begin, const sf::Time& t)
+{
+	const Index end = m_ends[begin];
+	Index skipEnd = begin;
+
+	for (Index i = begin; i < end; ++i)
+	{
+		if (i >= skipEnd)
+		{
+			m_nodes[i]->update(t);
+
+			// the children of a node ignoring them only follow it around
+			if (m_flags[i] & IGNORING_CHILDREN) skipEnd = m_ends[i];
+		}
+
+		updateTransform(i, i != begin && (m_flags[m_parents[i]] & CHANGED));
+	}
+}
+
+void SceneGraph::draw(Index begin, Renderer& renderer, const sf::RenderStates& states)
+{
+	updateTransforms(begin);
+
+	const Index end = m_ends[begin];
+	const sf::Uint8 layer = renderer.getLayer();
+	sf::RenderStates nodeStates = states;
+
+	for (Index i = begin; i < end;)
+	{
+		const Index parent = m_parents[i];
+		const BGO* node = m_nodes[i];
+
+		// drawn where the scene graph puts it, on top of whatever the caller asked for
+		nodeStates.transform = parent == NONE ? states.transform : states.transform * m_globals[parent];
+
+		if (renderer.isVisible(node->getBounds(), nodeStates.transform))
+		{
+			renderer.setLayer(layer + node->getLayer());
+			node->draw(renderer, nodeStates);
+		}
+
+		i = (m_flags[i] & IGNORING_CHILDREN) ? m_ends[i] : i + 1;
+	}
+
+	renderer.setLayer(layer);
+}
+
+const std::vector<BGO*>& SceneGraph::getComponents(Component component)
+{
+	if (m_componentsDirty)
+	{
+		for (std::vector<BGO*>& pool : m_components) pool.clear();
+
+		for (BGO* node : m_nodes) m_components[node->m_component].push_back(node);
+
+		m_componentsDirty = false;
+	}
+
+	return m_components[component];
+}
+
+void SceneGraph::updateTransform(Index i, bool parentChanged)
+{
+	if (!(m_flags[i] & GLOBAL_DIRTY) && !parentChanged)
+	{
+		m_flags[i] &= ~CHANGED;
+		return;
+	}
+
+	const sf::Transform& local = getLocalTransform(i);
+	const Index parent = m_parents[i];
+
+	m_globals[i] = parent == NONE ? local : m_globals[parent] * local;
+	m_flags[i] = (m_flags[i] & ~GLOBAL_DIRTY) | CHANGED;
+}
@@ -0,0 +1,88 @@
+#ifndef SCENEGRAPH_H
+#define SCENEGRAPH_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+class BGO;
+class Renderer;
+
+/**
+ * The storage behind a tree of game objects, flattened in depth-first order:
+ * the subtree of a node is the range [node, end of node), its parent always comes before it.
+ * Updating and drawing a subtree are sweeps over that range.
+ */
+class SceneGraph
+{
+public:
+	typedef unsigned int Index;
+
+	// What a game object is, each kind gets a pool of its own
+	enum Component
+	{
+		OBJECT,
+		SPRITE,
+		TEXT,
+		EMITTER,
+		COMPONENT_COUNT
+	};
+
+	static const Index NONE;
+
+	SceneGraph();
+
+	// Starts over with nothing but the root
+	void reset(BGO& root);
+
+	inline Index size() const { return static_cast<Index>(m_nodes.size()); }
+	inline BGO* getNode(Index i) const { return m_nodes[i]; }
+	inline Index getParent(Index i) const { return m_parents[i]; }
+	inline Index getEnd(Index i) const { return m_ends[i]; }
+	// Whether node i is within the subtree of node root
+	inline bool contains(Index root, Index i) const { return i >= root && i < m_ends[root]; }
+
+	// Moves everything in the subtree graph (emptying it) under the parent, behind its other children
+	void attach(Index parent, SceneGraph& subtree);
+	// Moves the subtree of node i back into the graph of its root node
+	void detach(Index i);
+
+	bool isIgnoringChildren(Index i) const;
+	void setIgnoringChildren(Index i, bool arg);
+
+	const sf::Transform& getLocalTransform(Index i);
+	inline const sf::Transform& getGlobalTransform(Index i) const { return m_globals[i]; }
+	void invalidateTransform(Index i);
+
+	// SWEEPS (over the subtree of node begin)
+	void updateTransforms(Index begin);
+	void update(Index begin, const sf::Time& t);
+	void draw(Index begin, Renderer& renderer, const sf::RenderStates& states);
+
+	// The game objects of one kind, in depth-first order
+	const std::vector<BGO*>& getComponents(Component component);
+
+private:
+	enum Flags
+	{
+		LOCAL_DIRTY = 1 << 0,
+		GLOBAL_DIRTY = 1 << 1,
+		IGNORING_CHILDREN = 1 << 2,
+		// set while sweeping, for the children to know that their parent moved
+		CHANGED = 1 << 3
+	};
+
+	void updateTransform(Index i, bool parentChanged);
+
+	std::vector<BGO*> m_nodes;
+	std::vector<Index> m_parents;
+	std::vector<Index> m_ends;
+	std::vector<sf::Transform> m_locals;
+	std::vector<sf::Transform> m_globals;
+	std::vector<sf::Uint8> m_flags;
+
+	// rebuilt when next asked for after the nodes changed
+	std::vector<BGO*> m_components[COMPONENT_COUNT];
+	bool m_componentsDirty;
+};
+
+#endif // SCENEGRAPH_H
@@ -3,7 +3,20 @@
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Has bounds, to be culled when out of view.
+ *
+ *             October 18, 2026
+ *             The transform is only recomputed once the text has been changed.
+ *
+ *             October 18, 2026
+ *             Pooled with the other texts of its scene graph.
+ *
+ *             October 18, 2026
+ *             Drawn as a vertex range of its glyphs, laid out on the thread that records the draws.
+ *
+ *             October 18, 2026
+ *             Only uses the glyphs prepared ahead of time, and measures itself with them instead of through sf::Text.
  *
  * @designer   Melvin Loho
  *
@@ -13,19 +26,25 @@
  */
 
 #include "TGO.h"
+#include "Glyph.h"
 
 #include "../Renderer.h"
 
+#include <algorithm>
+
 /**
  * Constructor.
  */
-TGO::TGO()
+TGO::TGO() :
+BGO(SceneGraph::TEXT),
+glyphsDirty(true)
 {}
 
 /**
 * Constructor.
 */
-TGO::TGO(const sf::String& string, const sf::Font& font, unsigned int characterSize) : data(string, font, characterSize)
+TGO::TGO(const sf::String& string, const sf::Font& font, unsigned int characterSize) : BGO(SceneGraph::TEXT), data(string, font, characterSize),
+glyphsDirty(true)
 {}
 
 /**
@@ -39,7 +58,11 @@ TGO::~TGO()
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Invalidates the cached transform.
+ *
+ *             October 18, 2026
+ *             Invalidates the glyphs too.
  *
  * @designer   Melvin Loho
  *
@@ -49,6 +72,10 @@ TGO::~TGO()
  */
 sf::Text& TGO::text()
 {
+	// whoever gets to change it might move it, or change what it shows
+	invalidateTransform();
+	glyphsDirty = true;
+
 	return data;
 }
 
@@ -75,7 +102,8 @@ const sf::Text& TGO::text() const
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Only called when the cached transform is out of date.
  *
  * @designer   Melvin Loho
  *
@@ -83,11 +111,32 @@ const sf::Text& TGO::text() const
  *
  * @return     The transformation matrix
  */
-sf::Transform TGO::getLocalTransform() const
+sf::Transform TGO::computeLocalTransform() const
 {
 	return data.getTransform();
 }
 
+/**
+ * Gets the bounds of the text represented by this game object.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions  October 18, 2026
+ *             Those of its own glyphs, sf::Text would look up glyphs that weren't prepared.
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @return     The bounds, transformed by the local transformation
+ */
+sf::FloatRect TGO::getBounds() const
+{
+	if (glyphsDirty) buildGlyphs();
+
+	return getLocalTransform().transformRect(glyphBounds);
+}
+
 /**
  * Sets the anchor point to one of the following:
  * > the middle of the text
@@ -95,7 +144,8 @@ sf::Transform TGO::getLocalTransform() const
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Measured with its own glyphs.
  *
  * @designer   Melvin Loho
  *
@@ -107,10 +157,99 @@ void TGO::middleAnchorPoint(bool arg)
 {
 	if (arg)
 	{
-		const sf::FloatRect &bounds = data.getLocalBounds();
+		if (glyphsDirty) buildGlyphs();
+
+		const sf::FloatRect &bounds = glyphBounds;
 		data.setOrigin(bounds.width * 0.5f, bounds.height * 0.5f);
 	}
 	else data.setOrigin(0.f, 0.f);
+
+	invalidateTransform();
+}
+
+/**
+ * Lays the glyphs of the text out, the way sf::Text would, relative to its local transformation, and measures them.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions  October 18, 2026
+ *             Only looks up prepared glyphs.
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ */
+void TGO::buildGlyphs() const
+{
+	glyphs.clear();
+	glyphBounds = sf::FloatRect();
+	glyphsDirty = false;
+
+	const sf::Font* font = data.getFont();
+	if (!font) return;
+
+	const unsigned int characterSize = data.getCharacterSize();
+	if (!AreGlyphsPrepared(*font, characterSize)) throw "The glyphs of this character size were not prepared!!";
+
+	// only the regular glyphs get prepared
+	const sf::Color& color = data.getFillColor();
+
+	const float whitespace = font->getGlyph(L' ', characterSize, false).advance;
+	const float lineSpacing = font->getLineSpacing(characterSize);
+
+	float x = 0.f;
+	float y = static_cast<float>(characterSize);
+	sf::Uint32 previous = 0;
+
+	float left = 0.f, top = 0.f, right = 0.f, bottom = 0.f;
+	bool empty = true;
+
+	for (sf::Uint32 c : data.getString())
+	{
+		switch (c)
+		{
+		case L'\t':
+			x += whitespace * 4;
+			previous = 0;
+			continue;
+
+		case L'\n':
+			x = 0.f;
+			y += lineSpacing;
+			previous = 0;
+			continue;
+		}
+
+		// anything without a prepared glyph shows up as its stand-in, kerning included
+		c = PreparedCharacter(c);
+
+		x += font->getKerning(previous, c, characterSize);
+		previous = c;
+
+		if (c == L' ')
+		{
+			x += whitespace;
+			continue;
+		}
+
+		const sf::Glyph& glyph = font->getGlyph(c, characterSize, false);
+
+		AddGlyph(glyphs, x, y, color, glyph);
+
+		// like sf::Text, the bounds are those of the glyphs without their padding
+		const float glyphLeft = x + glyph.bounds.left, glyphTop = y + glyph.bounds.top;
+		const float glyphRight = glyphLeft + glyph.bounds.width, glyphBottom = glyphTop + glyph.bounds.height;
+
+		left = empty ? glyphLeft : std::min(left, glyphLeft);
+		top = empty ? glyphTop : std::min(top, glyphTop);
+		right = empty ? glyphRight : std::max(right, glyphRight);
+		bottom = empty ? glyphBottom : std::max(bottom, glyphBottom);
+		empty = false;
+
+		x += glyph.advance;
+	}
+
+	if (!empty) glyphBounds = sf::FloatRect(left, top, right - left, bottom - top);
 }
 
 /**
@@ -118,7 +257,8 @@ void TGO::middleAnchorPoint(bool arg)
  *
  * @date       2015-02-25
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Drawn as a vertex range with the font's texture, it batches with the other texts of that size.
  *
  * @designer   Melvin Loho
  *
@@ -129,5 +269,14 @@ void TGO::middleAnchorPoint(bool arg)
  */
 void TGO::draw(Renderer& renderer, sf::RenderStates states) const
 {
-	renderer.draw(*this, states);
+	const sf::Font* font = data.getFont();
+	if (!font) return;
+
+	// laid out while recording, whatever frame gets drawn only ever holds copies of the vertices
+	if (glyphsDirty) buildGlyphs();
+
+	states.transform.combine(getLocalTransform());
+	states.texture = &font->getTexture(data.getCharacterSize());
+
+	renderer.draw(glyphs.data(), glyphs.size(), sf::PrimitiveType::Triangles, states);
 }
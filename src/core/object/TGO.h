@@ -3,6 +3,8 @@
 
 #include "BGO.h"
 
+#include <vector>
+
 class Renderer;
 
 class TGO : public BGO
@@ -16,15 +18,23 @@ public:
 	sf::Text& text();
 	const sf::Text& text() const;
 
-	sf::Transform getLocalTransform() const override;
+	sf::FloatRect getBounds() const override;
 
 	void middleAnchorPoint(bool arg);
 
 protected:
+	sf::Transform computeLocalTransform() const override;
 	void draw(Renderer& renderer, sf::RenderStates states) const override;
 
 private:
+	void buildGlyphs() const;
+
 	sf::Text data;
+
+	// laid out when drawn after the text has been changed, the renderer only ever gets these
+	mutable std::vector<sf::Vertex> glyphs;
+	mutable sf::FloatRect glyphBounds;
+	mutable bool glyphsDirty;
 };
 
 #endif // TGO_H
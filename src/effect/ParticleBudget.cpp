@@ -0,0 +1,147 @@
+/**
+ * Particle budget.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @notes      Caps the number of live particles across every particle system to hold a target frame time.
+ *             The budget shrinks from the current particle count while the frames take too long
+ *             and grows back slowly while they are well within the target.
+ *             It is shared in proportion to the priorities, no system gets more than it can hold
+ *             and whatever it can't use goes to the others.
+ *             A system's share becomes its cap, its spawn rate and lifetime are both scaled
+ *             by the square root of the share over its capacity so that their product follows the share.
+ */
+
+#include "ParticleBudget.h"
+#include "ParticleSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+const sf::Time ParticleBudget::DEFAULT_TARGET_FRAME_TIME = sf::seconds(1.f / 60.f);
+const unsigned int ParticleBudget::MIN_BUDGET = 1000;
+
+ParticleBudget::ParticleBudget(sf::Time targetFrameTime) :
+	targetFrameTime(targetFrameTime),
+	averageFrameTime(targetFrameTime.asSeconds()),
+	budget(0),
+	capacity(0),
+	particleCount(0),
+	firstFrame(true)
+{}
+
+void ParticleBudget::setTargetFrameTime(sf::Time targetFrameTime)
+{
+	this->targetFrameTime = targetFrameTime;
+}
+
+void ParticleBudget::clear()
+{
+	systems.clear();
+}
+
+void ParticleBudget::add(ParticleSystem* ps, float priority)
+{
+	systems.push_back(Entry{ ps, std::max(priority, 0.f), 0 });
+}
+
+void ParticleBudget::apply(sf::Time frameTime)
+{
+	capacity = particleCount = 0;
+
+	for (const Entry& e : systems)
+	{
+		capacity += e.ps->getParticleCapacity();
+		particleCount += e.ps->getParticleCount();
+	}
+
+	// start out unlimited, the frame times tell how much the machine can take
+	if (firstFrame)
+	{
+		firstFrame = false;
+		budget = capacity;
+	}
+
+	// smooth out the odd slow frame
+	averageFrameTime += (frameTime.asSeconds() - averageFrameTime) * 0.1f;
+
+	const float target = targetFrameTime.asSeconds();
+
+	if (averageFrameTime > target * 1.1f)
+	{
+		// cut from what is actually alive, an unused budget would take a while to shrink
+		budget = static_cast<unsigned int>(std::min(budget, particleCount) * 0.97f);
+	}
+	else if (averageFrameTime < target * 0.9f)
+	{
+		budget = static_cast<unsigned int>(budget * 1.02f) + 10;
+	}
+
+	budget = std::max(MIN_BUDGET, std::min(budget, capacity));
+
+	share();
+
+	for (const Entry& e : systems)
+	{
+		const unsigned int systemCapacity = e.ps->getParticleCapacity();
+		const float scale = std::sqrt(systemCapacity ? static_cast<float>(e.share) / systemCapacity : 1.f);
+
+		ParticleSystem::LOD lod;
+		lod.cap = e.share;
+		lod.spawnScale = scale;
+		lod.lifeTimeScale = scale;
+
+		e.ps->setLOD(lod);
+	}
+}
+
+void ParticleBudget::share()
+{
+	unsigned int remaining = budget;
+	std::vector<Entry*> open;
+
+	for (Entry& e : systems)
+	{
+		e.share = 0;
+		open.push_back(&e);
+	}
+
+	// hand out in proportion to the priorities, systems that fill up give the rest back to the others
+	while (remaining > 0 && !open.empty())
+	{
+		float totalPriority = 0.f;
+		for (Entry* e : open) totalPriority += e->priority;
+
+		unsigned int handedOut = 0;
+
+		for (std::vector<Entry*>::iterator it = open.begin(); it != open.end();)
+		{
+			Entry* e = *it;
+			const unsigned int room = e->ps->getParticleCapacity() - e->share;
+			const float fraction = totalPriority > 0.f ? e->priority / totalPriority : 1.f / open.size();
+			const unsigned int portion = std::min(room, static_cast<unsigned int>(remaining * fraction));
+
+			e->share += portion;
+			handedOut += portion;
+
+			if (e->share >= e->ps->getParticleCapacity()) it = open.erase(it);
+			else ++it;
+		}
+
+		// whatever is left after rounding goes to the highest priority
+		if (handedOut == 0)
+		{
+			Entry* top = *std::max_element(open.begin(), open.end(), [](const Entry* a, const Entry* b) { return a->priority < b->priority; });
+			top->share += std::min(remaining, top->ps->getParticleCapacity() - top->share);
+			break;
+		}
+
+		remaining -= handedOut;
+	}
+}
@@ -0,0 +1,51 @@
+#ifndef PARTICLEBUDGET_H
+#define PARTICLEBUDGET_H
+
+#include <vector>
+#include <SFML/System.hpp>
+
+class ParticleSystem;
+
+class ParticleBudget
+{
+public:
+	static const sf::Time DEFAULT_TARGET_FRAME_TIME;
+	static const unsigned int MIN_BUDGET;
+
+	ParticleBudget(sf::Time targetFrameTime = DEFAULT_TARGET_FRAME_TIME);
+
+	void setTargetFrameTime(sf::Time targetFrameTime);
+
+	// Systems to share the budget among this frame, the higher the priority the bigger the share
+	void clear();
+	void add(ParticleSystem* ps, float priority);
+
+	// Adjusts the budget to the last frame time and hands out every system's level of detail
+	void apply(sf::Time frameTime);
+
+	inline sf::Time getTargetFrameTime() const { return targetFrameTime; }
+	inline sf::Time getFrameTime() const { return sf::seconds(averageFrameTime); }
+	inline unsigned int getBudget() const { return budget; }
+	inline unsigned int getCapacity() const { return capacity; }
+	inline unsigned int getParticleCount() const { return particleCount; }
+
+private:
+	struct Entry
+	{
+		ParticleSystem* ps;
+		float priority;
+		unsigned int share;
+	};
+
+	void share();
+
+	std::vector<Entry> systems;
+
+	sf::Time targetFrameTime;
+	float averageFrameTime;
+
+	unsigned int budget, capacity, particleCount;
+	bool firstFrame;
+};
+
+#endif // PARTICLEBUDGET_H
@@ -9,13 +9,55 @@
  *             2015-??-??
  *             Improved performance by changing when the particles are built.
  *
+ *             October 18, 2026
+ *             The particles are stored as a structure of arrays and updated a whole system at a time.
+ *
+ *             October 18, 2026
+ *             The live particles are kept packed at the front so that only they are updated and built.
+ *
+ *             October 18, 2026
+ *             The particle loops are policies that ParticleSystemT inlines, this class is the runtime adapter.
+ *
+ *             October 18, 2026
+ *             Each system spawns from its own random stream, a batch of particles at a time.
+ *
+ *             October 18, 2026
+ *             The particles of a system can be updated in chunks on a job system.
+ *
+ *             October 18, 2026
+ *             The vertices are built in chunks at the end of the update, drawing only submits them.
+ *
+ *             October 18, 2026
+ *             The spawning follows a level of detail, handed out by the particle budget.
+ *
+ *             October 18, 2026
+ *             Can be reset to be reused.
+ *
+ *             October 18, 2026
+ *             The vertices join the renderer's batch, systems drawn alike share a draw call.
+ *
+ *             October 18, 2026
+ *             Points drawn through a shader keep their texture, the shader may turn them into sprites.
+ *
+ *             October 18, 2026
+ *             What an update off the main thread works out for the emitter is applied on the main thread.
+ *
+ *             October 18, 2026
+ *             Keeps track of its bounds, chunks of particles out of the cull rect are neither built nor drawn.
+ *
+ *             October 18, 2026
+ *             The transform is only recomputed once the emitter has moved.
+ *
+ *             October 18, 2026
+ *             Pooled with the other emitters of its scene graph.
+ *
  * @designer   Melvin Loho
  *
  * @programmer Melvin Loho
  *
  * @notes      A flexible particle system that can be customized in terms of:
  *             - what determines the death of a particle
- *             - how a particle is updated over time
+ *             - how the particles are updated over time
  *             - how a particle is built so that it can be displayed on the screen
  *
  *             Currently holds a number of variables to affect each particle.
@@ -26,13 +68,18 @@
  */
 
 #include "ParticleSystem.h"
+#include "ParticleSystemT.h"
 
+#include <algorithm>
 #include <math.h>
 #include "../core/Renderer.h"
+#include "../engine/JobSystem.h"
 
-unsigned int ParticleSystem::TotalParticleCount = 0;
+const unsigned int ParticleSystem::UPDATE_CHUNK_SIZE = 1024;
+const unsigned int ParticleSystem::BUILD_CHUNK_SIZE = 512;
 
 ParticleSystem::ParticleSystem(unsigned int particleAmount) :
+BGO(SceneGraph::EMITTER),
 emitterPos(0.f, 0.f),
 spawnRate(1),
 colorBegin(sf::Color::White), colorEnd(sf::Color::White),
@@ -41,19 +88,38 @@ lifeTimeMin(sf::seconds(1.f)), lifeTimeMax(sf::seconds(1.f)),
 velMin(1.f), velMax(1.f),
 angleOffsetMin(0.f), angleOffsetMax(0.f),
 
-m_particleCount(particleAmount), m_vertexCount(0),
+m_particleCount(particleAmount),
+m_aliveCount(0),
+m_vertexCount(0),
 m_builder(&ParticleBuilders::pbSprite),
 m_pType(m_builder->getType()),
 m_vCountMax(m_builder->getCount()),
 m_singleParticleVertexCount(m_vCountMax),
-m_particles(new Particle[m_particleCount]),
 m_vertices(new sf::Vertex[m_particleCount * SPRITE_VERTICES]),
-dirtyVertices(true)
+m_cullRect(BGO::NO_BOUNDS),
+m_bounds(0.f, 0.f, 0.f, 0.f),
+m_chunkCount(0),
+m_chunkBounds((m_particleCount + BUILD_CHUNK_SIZE - 1) / BUILD_CHUNK_SIZE),
+m_chunkVisible(m_chunkBounds.size())
 {
-	for (unsigned int p = 0; p < m_particleCount; ++p)
-	{
-		m_particles[p] = Particle();
-	}
+	m_lod.cap = m_particleCount;
+	m_lod.spawnScale = m_lod.lifeTimeScale = 1.f;
+
+	// one block for the floats and one for the colour channels, each array following the previous one
+	float *floats = new float[m_particleCount * 5]();
+	sf::Uint8 *channels = new sf::Uint8[m_particleCount * 4]();
+
+	m_particles.posX = floats;
+	m_particles.posY = floats + m_particleCount;
+	m_particles.lifetime = floats + m_particleCount * 2;
+	m_particles.vel = floats + m_particleCount * 3;
+	m_particles.angleOffset = floats + m_particleCount * 4;
+
+	m_particles.r = channels;
+	m_particles.g = channels + m_particleCount;
+	m_particles.b = channels + m_particleCount * 2;
+	m_particles.a = channels + m_particleCount * 3;
+
 	for (unsigned int p = 0; p < m_particleCount * SPRITE_VERTICES; ++p)
 	{
 		m_vertices[p] = sf::Vertex();
@@ -62,15 +128,14 @@ dirtyVertices(true)
 
 ParticleSystem::~ParticleSystem()
 {
-	delete[] m_particles;
+	delete[] m_particles.posX;
+	delete[] m_particles.r;
 	delete[] m_vertices;
 }
 
-sf::Transform ParticleSystem::getLocalTransform() const
+sf::Transform ParticleSystem::computeLocalTransform() const
 {
-	static sf::Transform localtrans = sf::Transform::Identity;
-
-	localtrans = sf::Transform::Identity;
+	sf::Transform localtrans;
 	localtrans.translate(emitterPos);
 
 	return localtrans;
@@ -78,61 +143,190 @@ sf::Transform ParticleSystem::getLocalTransform() const
 
 void ParticleSystem::draw(Renderer &renderer, sf::RenderStates states) const
 {
-	if (dirtyVertices)
-	{
-		dirtyVertices = false;
-		m_vertexCount = m_builder->build(*this, m_particleCount, m_particles, m_vertices);
-	}
-
-	if (m_pType == sf::PrimitiveType::Points)
+	if (m_pType == sf::PrimitiveType::Points && !states.shader)
 		states.texture = nullptr;
 	else
 		states.texture = m_texture;
 
-	renderer.sf_draw(m_vertices, m_vertexCount, m_pType, states);
+	// every run of visible chunks in one go, they end up in the same batch anyway
+	const unsigned int vertexStride = m_singleParticleVertexCount;
+
+	for (unsigned int chunk = 0; chunk < m_chunkCount;)
+	{
+		if (!m_chunkVisible[chunk])
+		{
+			++chunk;
+			continue;
+		}
+
+		const unsigned int begin = chunk * BUILD_CHUNK_SIZE;
+
+		while (chunk < m_chunkCount && m_chunkVisible[chunk]) ++chunk;
+
+		const unsigned int end = std::min(chunk * BUILD_CHUNK_SIZE, m_aliveCount);
+
+		renderer.draw(m_vertices + begin * vertexStride, (end - begin) * vertexStride, m_pType, states);
+	}
 }
 
 void ParticleSystem::update(const sf::Time &deltaTime)
 {
-	unsigned int p = 0, spawnCount = 0;
+	step(deltaTime, nullptr);
+	applyEmitter();
+}
 
-	// SPAWN & UPDATE PARTICLES
+void ParticleSystem::update(const sf::Time &deltaTime, JobSystem &jobs)
+{
+	step(deltaTime, &jobs);
+}
 
-	for (; p < m_particleCount; ++p)
+void ParticleSystem::step(const sf::Time &deltaTime, JobSystem *jobs)
+{
+	// the emitter is moved around directly, the transform finds out here
+	if (emitterPos != m_transformPos)
+	{
+		m_transformPos = emitterPos;
+		invalidateTransform();
+	}
+
+	// SPAWN PARTICLES (appended behind the live ones, as many as the level of detail allows)
+
+	const unsigned int lodSpawnRate = spawnRate ? std::max(1u, static_cast<unsigned int>(spawnRate * m_lod.spawnScale + 0.5f)) : 0;
+	const unsigned int cap = std::min(m_lod.cap, m_particleCount);
+
+	const unsigned int spawnBegin = m_aliveCount;
+	const unsigned int spawnEnd = std::max(spawnBegin, std::min(m_aliveCount + lodSpawnRate, cap));
+	const unsigned int spawnCount = spawnEnd - spawnBegin;
+
+	std::fill(m_particles.posX + spawnBegin, m_particles.posX + spawnEnd, emitterPos.x);
+	std::fill(m_particles.posY + spawnBegin, m_particles.posY + spawnEnd, emitterPos.y);
+	std::fill(m_particles.r + spawnBegin, m_particles.r + spawnEnd, colorBegin.r);
+	std::fill(m_particles.g + spawnBegin, m_particles.g + spawnEnd, colorBegin.g);
+	std::fill(m_particles.b + spawnBegin, m_particles.b + spawnEnd, colorBegin.b);
+	std::fill(m_particles.a + spawnBegin, m_particles.a + spawnEnd, colorBegin.a);
+
+	m_random.range(m_particles.lifetime + spawnBegin, spawnCount, lifeTimeMin.asSeconds() * m_lod.lifeTimeScale, lifeTimeMax.asSeconds() * m_lod.lifeTimeScale);
+	m_random.range(m_particles.vel + spawnBegin, spawnCount, velMin, velMax);
+	m_random.range(m_particles.angleOffset + spawnBegin, spawnCount, angleOffsetMin, angleOffsetMax);
+
+	m_aliveCount = spawnEnd;
+
+	// UPDATE PARTICLES (spawning and removing stay serial, they touch the whole array)
+
+	const float dt = deltaTime.asSeconds();
+
+	if (jobs && m_aliveCount > UPDATE_CHUNK_SIZE)
 	{
-		if (spawnCount >= spawnRate) break;
+		JobSystem::Group chunks;
 
-		if (isDead(m_particles[p]))
+		jobs->runChunked(chunks, m_aliveCount, UPDATE_CHUNK_SIZE, [this, dt](unsigned int begin, unsigned int end)
 		{
-			++spawnCount;
-			m_particles[p].pos = emitterPos;
-			m_particles[p].clr = colorBegin;
-			m_particles[p].lifetime = lifeTimeMin + sf::microseconds(rand()) / (sf::microseconds(RAND_MAX) / (lifeTimeMax - lifeTimeMin));
-			m_particles[p].vel = velMin + static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / (velMax - velMin)));
-			m_particles[p].angleOffset = angleOffsetMin + static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / (angleOffsetMax - angleOffsetMin)));
-		}
+			updateParticles(dt, begin, end);
+		});
+
+		jobs->wait(chunks);
+	}
+	else
+	{
+		updateParticles(dt, 0, m_aliveCount);
+	}
 
-		updateParticle(deltaTime, m_particles[p]);
+	// REMOVE DEAD PARTICLES
+
+	removeDead();
+
+	// UPDATE THE REST
+
+	updateEmitter(deltaTime);
+
+	// BUILD VERTICES (every particle gets the same number of vertices and the live ones are packed,
+	// so the vertices of a chunk start right after those of the particles before it)
+	// Chunks out of the cull rect are skipped, so a system out of view builds nothing
+
+	const unsigned int vertexStride = m_singleParticleVertexCount;
+	const float margin = getCullMargin();
+	const bool culling = m_cullRect.width >= 0.f;
+
+	auto buildChunk = [this, vertexStride, margin, culling](unsigned int begin, unsigned int end)
+	{
+		const unsigned int chunk = begin / BUILD_CHUNK_SIZE;
+
+		m_chunkBounds[chunk] = getChunkBounds(begin, end, margin);
+		m_chunkVisible[chunk] = !culling || m_chunkBounds[chunk].intersects(m_cullRect);
+
+		if (m_chunkVisible[chunk]) buildVertices(begin, end, m_vertices + begin * vertexStride);
+	};
+
+	m_chunkCount = (m_aliveCount + BUILD_CHUNK_SIZE - 1) / BUILD_CHUNK_SIZE;
+
+	if (jobs && m_aliveCount > BUILD_CHUNK_SIZE)
+	{
+		JobSystem::Group chunks;
+
+		jobs->runChunked(chunks, m_aliveCount, BUILD_CHUNK_SIZE, buildChunk);
+
+		jobs->wait(chunks);
+	}
+	else
+	{
+		for (unsigned int begin = 0; begin < m_aliveCount; begin += BUILD_CHUNK_SIZE)
+		{
+			buildChunk(begin, std::min(begin + BUILD_CHUNK_SIZE, m_aliveCount));
+		}
 	}
 
-	// UPDATE REMAINING PARTICLES
+	// BOUNDS (of the whole system)
+
+	m_bounds = sf::FloatRect(emitterPos.x, emitterPos.y, 0.f, 0.f);
+	m_vertexCount = 0;
 
-	for (; p < m_particleCount; ++p)
+	for (unsigned int chunk = 0; chunk < m_chunkCount; ++chunk)
 	{
-		updateParticle(deltaTime, m_particles[p]);
+		const sf::FloatRect &bounds = m_chunkBounds[chunk];
+
+		if (chunk == 0)
+		{
+			m_bounds = bounds;
+		}
+		else
+		{
+			const float right = std::max(m_bounds.left + m_bounds.width, bounds.left + bounds.width);
+			const float bottom = std::max(m_bounds.top + m_bounds.height, bounds.top + bounds.height);
+
+			m_bounds.left = std::min(m_bounds.left, bounds.left);
+			m_bounds.top = std::min(m_bounds.top, bounds.top);
+			m_bounds.width = right - m_bounds.left;
+			m_bounds.height = bottom - m_bounds.top;
+		}
+
+		if (m_chunkVisible[chunk])
+		{
+			m_vertexCount += (std::min((chunk + 1) * BUILD_CHUNK_SIZE, m_aliveCount) - chunk * BUILD_CHUNK_SIZE) * vertexStride;
+		}
 	}
+}
 
-	// UPDATE STATS
+sf::FloatRect ParticleSystem::getChunkBounds(unsigned int begin, unsigned int end, float margin) const
+{
+	const float *posX = m_particles.posX, *posY = m_particles.posY;
+	float minX = posX[begin], maxX = minX;
+	float minY = posY[begin], maxY = minY;
 
-	dirtyVertices = true;
-	TotalParticleCount += m_vertexCount / m_singleParticleVertexCount;
+	for (unsigned int p = begin + 1; p < end; ++p)
+	{
+		minX = std::min(minX, posX[p]);
+		maxX = std::max(maxX, posX[p]);
+		minY = std::min(minY, posY[p]);
+		maxY = std::max(maxY, posY[p]);
+	}
+
+	return sf::FloatRect(minX - margin, minY - margin, maxX - minX + margin * 2.f, maxY - minY + margin * 2.f);
 }
 
 void ParticleSystem::setTexture(const sf::Texture &texture)
 {
 	m_texture = &texture;
 	m_textureSize = static_cast <sf::Vector2f> (m_texture->getSize());
-	m_spriteHalfSize = m_textureSize * 0.5f;
 }
 
 void ParticleSystem::setBuilder(ParticleBuilder &builder)
@@ -141,93 +335,142 @@ void ParticleSystem::setBuilder(ParticleBuilder &builder)
 	m_builder = &builder;
 	m_pType = builder.getType();
 	m_singleParticleVertexCount = builder.getCount();
+
+	// the vertices built so far are of the previous builder, they are rebuilt with the next update
+	m_vertexCount = 0;
+	m_chunkCount = 0;
+}
+
+void ParticleSystem::setCullRect(const sf::FloatRect &rect)
+{
+	m_cullRect = rect;
+}
+
+sf::FloatRect ParticleSystem::getBounds() const
+{
+	return m_bounds;
+}
+
+float ParticleSystem::getCullMargin() const
+{
+	// a sprite is never bigger than its texture
+	return std::max(m_textureSize.x, m_textureSize.y) * 0.5f;
 }
 
 void ParticleSystem::clear()
 {
-	for (unsigned int p = 0; p < m_particleCount; ++p)
-	{
-		m_particles[p].lifetime = sf::Time::Zero;
-	}
+	m_aliveCount = 0;
+	m_vertexCount = 0;
+	m_chunkCount = 0;
+	m_bounds = sf::FloatRect(emitterPos.x, emitterPos.y, 0.f, 0.f);
 }
 
-unsigned int ParticleSystem::getParticleCount() const
+void ParticleSystem::reset()
 {
-	return m_vertexCount / m_singleParticleVertexCount;
+	clear();
+
+	emitterPos = sf::Vector2f(0.f, 0.f);
+	m_cullRect = BGO::NO_BOUNDS;
+
+	m_lod.cap = m_particleCount;
+	m_lod.spawnScale = m_lod.lifeTimeScale = 1.f;
 }
 
-unsigned int ParticleSystem::getVertexCount() const
+void ParticleSystem::seed(sf::Uint64 seed)
 {
-	return m_vertexCount;
+	m_random.seed(seed);
 }
 
-void ParticleSystem::updateParticle(const sf::Time &deltaTime, Particle &p)
-{}
+unsigned int ParticleSystem::getParticleCount() const
+{
+	return m_aliveCount;
+}
 
-bool ParticleSystem::isDead(const Particle &p) const
+unsigned int ParticleSystem::getParticleCapacity() const
 {
-	return (p.lifetime <= sf::Time::Zero);
+	return m_particleCount;
 }
 
-unsigned int ParticleBuilders::PbSprite::build(const ParticleSystem &ps, const unsigned int &m_particleCount, const ParticleSystem::Particle *m_particles, sf::Vertex *m_vertices)
+void ParticleSystem::setLOD(const LOD &lod)
 {
-	unsigned int m_vertexCount = 0;
+	m_lod = lod;
+}
 
-	for (unsigned int p = 0; p < m_particleCount; ++p)
-	{
-		if (!ps.isDead(m_particles[p]))
-		{
-			const sf::Vector2f& pos = m_particles[p].pos;
-			const sf::Color& color = m_particles[p].clr;
-			const sf::Vector2f& size = (m_particles[p].lifetime / ps.lifeTimeMax) * ps.m_spriteHalfSize;
-			sf::Vertex *duplicateVertex1, *duplicateVertex2;
+unsigned int ParticleSystem::getVertexCount() const
+{
+	return m_vertexCount;
+}
 
-			/* 0 */ setVertex(m_vertices[m_vertexCount++], pos.x - size.x, pos.y - size.y, 0.f, 0.f, color);
+void ParticleSystem::updateParticles(float deltaTime, unsigned int begin, unsigned int end)
+{
+	ParticlePolicies::Age::update(*this, m_particles.from(begin), end - begin, deltaTime);
+}
 
-			duplicateVertex1 = &m_vertices[m_vertexCount++];
-			duplicateVertex2 = &m_vertices[m_vertexCount++];
+void ParticleSystem::updateEmitter(const sf::Time &deltaTime)
+{}
 
-			/* 1 */ setVertex(*duplicateVertex1, pos.x - size.x, pos.y + size.y, 0.f, ps.m_textureSize.y, color);
-			/* 2 */ setVertex(*duplicateVertex2, pos.x + size.x, pos.y - size.y, ps.m_textureSize.x, 0.f, color);
+void ParticleSystem::applyEmitter()
+{}
 
-			/* 1 */ m_vertices[m_vertexCount++] = *duplicateVertex1;
-			/* 2 */ m_vertices[m_vertexCount++] = *duplicateVertex2;
-			/* 3 */ setVertex(m_vertices[m_vertexCount++], pos.x + size.x, pos.y + size.y, ps.m_textureSize.x, ps.m_textureSize.y, color);
-		}
+void ParticleSystem::removeDead()
+{
+	for (unsigned int p = 0; p < m_aliveCount;)
+	{
+		if (isDead(p)) kill(p);
+		else ++p;
 	}
+}
 
-	return m_vertexCount;
+void ParticleSystem::buildVertices(unsigned int begin, unsigned int end, sf::Vertex *vertices) const
+{
+	m_builder->build(*this, begin, end, vertices);
+}
+
+void ParticleSystem::kill(unsigned int p)
+{
+	// swap-remove: the last live particle takes the dead one's slot
+	const unsigned int last = --m_aliveCount;
+
+	m_particles.posX[p] = m_particles.posX[last];
+	m_particles.posY[p] = m_particles.posY[last];
+	m_particles.lifetime[p] = m_particles.lifetime[last];
+	m_particles.vel[p] = m_particles.vel[last];
+	m_particles.angleOffset[p] = m_particles.angleOffset[last];
+	m_particles.r[p] = m_particles.r[last];
+	m_particles.g[p] = m_particles.g[last];
+	m_particles.b[p] = m_particles.b[last];
+	m_particles.a[p] = m_particles.a[last];
+}
+
+bool ParticleSystem::isDead(unsigned int p) const
+{
+	return ParticlePolicies::DieOfAge::isDead(m_particles, p);
+}
+
+void ParticleBuilders::PbSprite::build(const ParticleSystem &ps, unsigned int begin, unsigned int end, sf::Vertex *m_vertices)
+{
+	ParticlePolicies::BuildSprite::build(ps, ps.m_particles.from(begin), end - begin, m_vertices);
 }
 sf::PrimitiveType ParticleBuilders::PbSprite::getType() const
 {
-	return sf::PrimitiveType::Triangles;
+	return ParticlePolicies::BuildSprite::Type;
 }
 sf::Uint8 ParticleBuilders::PbSprite::getCount() const
 {
-	return SPRITE_VERTICES;
+	return ParticlePolicies::BuildSprite::Count;
 }
 
-unsigned int ParticleBuilders::PbPoint::build(const ParticleSystem &ps, const unsigned int &m_particleCount, const ParticleSystem::Particle *m_particles, sf::Vertex *m_vertices)
+void ParticleBuilders::PbPoint::build(const ParticleSystem &ps, unsigned int begin, unsigned int end, sf::Vertex *m_vertices)
 {
-	unsigned int m_vertexCount = 0;
-
-	for (unsigned int p = 0; p < m_particleCount; ++p)
-	{
-		if (!ps.isDead(m_particles[p]))
-		{
-			setVertex(m_vertices[m_vertexCount++], m_particles[p].pos.x, m_particles[p].pos.y, 0.f, 0.f, m_particles[p].clr);
-		}
-	}
-
-	return m_vertexCount;
+	ParticlePolicies::BuildPoint::build(ps, ps.m_particles.from(begin), end - begin, m_vertices);
 }
 sf::PrimitiveType ParticleBuilders::PbPoint::getType() const
 {
-	return sf::PrimitiveType::Points;
+	return ParticlePolicies::BuildPoint::Type;
 }
 sf::Uint8 ParticleBuilders::PbPoint::getCount() const
 {
-	return 1;
+	return ParticlePolicies::BuildPoint::Count;
 }
 
 ParticleBuilder &ParticleBuilders::pbSprite = *(new PbSprite());
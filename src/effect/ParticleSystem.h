@@ -2,7 +2,9 @@
 #define PARTICLESYSTEM_H
 
 #include "../core/object/BGO.h"
+#include "../core/Random.h"
 
+class JobSystem;
 class ParticleBuilder;
 
 class ParticleSystem : public BGO
@@ -10,33 +12,70 @@ class ParticleSystem : public BGO
 	friend class ParticleBuilders;
 
 public:
-	struct Particle
+	// The particles are stored as a structure of arrays so that they can be updated in tight loops
+	struct Particles
 	{
-		sf::Vector2f pos;
-		sf::Color clr;
-		sf::Time lifetime;
-		float vel;
-		float angleOffset;
+		float *posX, *posY;
+		float *lifetime; // in seconds
+		float *vel;
+		float *angleOffset;
+		sf::Uint8 *r, *g, *b, *a;
+
+		// The same arrays starting at particle p
+		inline Particles from(unsigned int p) const
+		{
+			Particles slice = { posX + p, posY + p, lifetime + p, vel + p, angleOffset + p, r + p, g + p, b + p, a + p };
+			return slice;
+		}
 	};
 
-	static unsigned int TotalParticleCount;
+	// Level of detail, scales the spawning without touching the settings below
+	struct LOD
+	{
+		unsigned int cap;    // most particles alive at once
+		float spawnScale;    // of spawnRate
+		float lifeTimeScale; // of lifeTimeMin and lifeTimeMax
+	};
+
+	// Live particles updated (and built) by a single job when updating on a job system
+	static const unsigned int UPDATE_CHUNK_SIZE;
+	static const unsigned int BUILD_CHUNK_SIZE;
 
 	ParticleSystem(unsigned int particleAmount = 5000);
 	virtual ~ParticleSystem();
 
-	sf::Transform getLocalTransform() const override;
 	void draw(Renderer &renderer, sf::RenderStates states) const override;
 	void update(const sf::Time &deltaTime) override;
+	// Same as update, with the particles updated in chunks on the job system.
+	// Can run on any thread, applyEmitter has to be called on the main thread once it's done.
+	void update(const sf::Time &deltaTime, JobSystem &jobs);
+	// Applies whatever the last update worked out that only the main thread may touch (e.g. sounds)
+	virtual void applyEmitter();
 
 	void setTexture(const sf::Texture &texture);
-	void setBuilder(ParticleBuilder &builder);
+	virtual void setBuilder(ParticleBuilder &builder);
+
+	// Only the chunks of particles within it get built (and drawn), a negative width (the default) builds them all
+	void setCullRect(const sf::FloatRect &rect);
+	// Of the live particles as of the last update
+	sf::FloatRect getBounds() const override;
+
+	inline const sf::Vector2f &getTextureSize() const { return m_textureSize; }
 
 	void clear();
+	// Back to how it was right after being constructed (except for its settings), ready to be reused
+	virtual void reset();
+	// Reseeds the random stream of the system, the same seed spawns the same particles
+	void seed(sf::Uint64 seed);
 
 	unsigned int getParticleCount() const;
+	unsigned int getParticleCapacity() const;
 	unsigned int getVertexCount() const;
 
-	virtual bool isDead(const Particle &p) const;
+	void setLOD(const LOD &lod);
+	inline const LOD &getLOD() const { return m_lod; }
+
+	virtual bool isDead(unsigned int p) const;
 
 	sf::Vector2f	emitterPos;
 	unsigned int	spawnRate;
@@ -47,43 +86,62 @@ public:
 	float			angleOffsetMin, angleOffsetMax;
 
 protected:
-	virtual void updateParticle(const sf::Time &deltaTime, Particle &p);
+	// Only the first m_aliveCount particles are alive, the rest are free slots
+	virtual void updateParticles(float deltaTime, unsigned int begin, unsigned int end);
+	// Updates whatever belongs to the system as a whole, after its particles
+	virtual void updateEmitter(const sf::Time &deltaTime);
+	virtual void removeDead();
+	// Builds the live particles [begin, end) into vertices, which already points at the vertices of particle begin
+	virtual void buildVertices(unsigned int begin, unsigned int end, sf::Vertex *vertices) const;
+	// How far from its position a particle can be drawn
+	virtual float getCullMargin() const;
+	// Follows the emitter, for whatever has been added to the system
+	sf::Transform computeLocalTransform() const override;
+
+	void kill(unsigned int p);
 
-private:
 	const unsigned int m_particleCount;
-	mutable unsigned int m_vertexCount;
+	unsigned int m_aliveCount;
+	Particles m_particles;
+
+private:
+	void step(const sf::Time &deltaTime, JobSystem *jobs);
+	sf::FloatRect getChunkBounds(unsigned int begin, unsigned int end, float margin) const;
+
+	unsigned int m_vertexCount;
+	Random m_random;
+
+	// where the emitter was when the transform was last invalidated
+	sf::Vector2f m_transformPos;
+	LOD m_lod;
 
 	ParticleBuilder *m_builder;
 	sf::PrimitiveType m_pType;
 	const sf::Uint8 m_vCountMax;
 	sf::Uint8 m_singleParticleVertexCount;
 
-	Particle *m_particles;
 	sf::Vertex *m_vertices;
-	mutable bool dirtyVertices;
 
 	const sf::Texture *m_texture;
-	sf::Vector2f m_textureSize, m_spriteHalfSize;
+	sf::Vector2f m_textureSize;
+
+	// CULLING (by chunks of BUILD_CHUNK_SIZE live particles)
+	sf::FloatRect m_cullRect, m_bounds;
+	unsigned int m_chunkCount;
+	std::vector<sf::FloatRect> m_chunkBounds;
+	std::vector<sf::Uint8> m_chunkVisible;
 };
 
 class ParticleBuilder
 {
 public:
-	virtual unsigned int build(const ParticleSystem &ps, const unsigned int &m_particleCount, const ParticleSystem::Particle *m_particles, sf::Vertex *m_vertices) = 0;
+	// Builds exactly getCount() vertices for each of the live particles [begin, end)
+	virtual void build(const ParticleSystem &ps, unsigned int begin, unsigned int end, sf::Vertex *m_vertices) = 0;
 	virtual sf::PrimitiveType getType() const = 0;
 	virtual sf::Uint8 getCount() const = 0;
-
-protected:
-	inline void setVertex(sf::Vertex& v, float xP, float yP, float xTC, float yTC, sf::Color c) const
-	{
-		v.position.x = xP;
-		v.position.y = yP;
-		v.texCoords.x = xTC;
-		v.texCoords.y = yTC;
-		v.color = c;
-	}
 };
 
+// Runtime adapters of the build policies (see ParticleSystemT.h)
 class ParticleBuilders
 {
 public:
@@ -94,14 +152,14 @@ private:
 	class PbSprite : public ParticleBuilder
 	{
 	public:
-		unsigned int build(const ParticleSystem &ps, const unsigned int &m_particleCount, const ParticleSystem::Particle *m_particles, sf::Vertex *m_vertices);
+		void build(const ParticleSystem &ps, unsigned int begin, unsigned int end, sf::Vertex *m_vertices) override;
 		sf::PrimitiveType getType() const override;
 		sf::Uint8 getCount() const override;
 	};
 	class PbPoint : public ParticleBuilder
 	{
 	public:
-		unsigned int build(const ParticleSystem &ps, const unsigned int &m_particleCount, const ParticleSystem::Particle *m_particles, sf::Vertex *m_vertices);
+		void build(const ParticleSystem &ps, unsigned int begin, unsigned int end, sf::Vertex *m_vertices) override;
 		sf::PrimitiveType getType() const override;
 		sf::Uint8 getCount() const override;
 	};
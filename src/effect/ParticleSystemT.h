@@ -0,0 +1,155 @@
+#ifndef PARTICLESYSTEMT_H
+#define PARTICLESYSTEMT_H
+
+#include "ParticleSystem.h"
+#include "../core/Renderer.h"
+
+// Compile-time building blocks of a particle system, each one a set of static functions
+struct ParticlePolicies
+{
+	typedef ParticleSystem::Particles Particles;
+
+	// UPDATE POLICIES
+
+	// Particles only get older
+	struct Age
+	{
+		static inline void update(const ParticleSystem &ps, const Particles &particles, unsigned int count, float deltaTime)
+		{
+			float *lifetime = particles.lifetime;
+
+			for (unsigned int p = 0; p < count; ++p)
+			{
+				lifetime[p] -= deltaTime;
+			}
+		}
+	};
+
+	// DEATH POLICIES
+
+	// Particles die once their lifetime runs out
+	struct DieOfAge
+	{
+		static inline bool isDead(const Particles &particles, unsigned int p)
+		{
+			return (particles.lifetime[p] <= 0.f);
+		}
+	};
+
+	// BUILD POLICIES
+
+	// Textured quads shrinking over the lifetime of the particle
+	struct BuildSprite
+	{
+		static const sf::PrimitiveType Type = sf::PrimitiveType::Triangles;
+		static const sf::Uint8 Count = SPRITE_VERTICES;
+
+		static inline unsigned int build(const ParticleSystem &ps, const Particles &particles, unsigned int count, sf::Vertex *vertices)
+		{
+			const float lifeTimeMax = ps.lifeTimeMax.asSeconds();
+			const sf::Vector2f &textureSize = ps.getTextureSize();
+			const sf::Vector2f halfSize = textureSize * 0.5f;
+			unsigned int vertexCount = 0;
+
+			for (unsigned int p = 0; p < count; ++p)
+			{
+				const sf::Vector2f pos(particles.posX[p], particles.posY[p]);
+				const sf::Color color(particles.r[p], particles.g[p], particles.b[p], particles.a[p]);
+				const sf::Vector2f size = (particles.lifetime[p] / lifeTimeMax) * halfSize;
+				sf::Vertex *duplicateVertex1, *duplicateVertex2;
+
+				/* 0 */ setVertex(vertices[vertexCount++], pos.x - size.x, pos.y - size.y, 0.f, 0.f, color);
+
+				duplicateVertex1 = &vertices[vertexCount++];
+				duplicateVertex2 = &vertices[vertexCount++];
+
+				/* 1 */ setVertex(*duplicateVertex1, pos.x - size.x, pos.y + size.y, 0.f, textureSize.y, color);
+				/* 2 */ setVertex(*duplicateVertex2, pos.x + size.x, pos.y - size.y, textureSize.x, 0.f, color);
+
+				/* 1 */ vertices[vertexCount++] = *duplicateVertex1;
+				/* 2 */ vertices[vertexCount++] = *duplicateVertex2;
+				/* 3 */ setVertex(vertices[vertexCount++], pos.x + size.x, pos.y + size.y, textureSize.x, textureSize.y, color);
+			}
+
+			return vertexCount;
+		}
+
+		static inline ParticleBuilder &runtime() { return ParticleBuilders::pbSprite; }
+	};
+
+	// Untextured points
+	struct BuildPoint
+	{
+		static const sf::PrimitiveType Type = sf::PrimitiveType::Points;
+		static const sf::Uint8 Count = 1;
+
+		static inline unsigned int build(const ParticleSystem &ps, const Particles &particles, unsigned int count, sf::Vertex *vertices)
+		{
+			for (unsigned int p = 0; p < count; ++p)
+			{
+				setVertex(vertices[p], particles.posX[p], particles.posY[p], 0.f, 0.f,
+					sf::Color(particles.r[p], particles.g[p], particles.b[p], particles.a[p]));
+			}
+
+			return count;
+		}
+
+		static inline ParticleBuilder &runtime() { return ParticleBuilders::pbPoint; }
+	};
+
+	static inline void setVertex(sf::Vertex& v, float xP, float yP, float xTC, float yTC, sf::Color c)
+	{
+		v.position.x = xP;
+		v.position.y = yP;
+		v.texCoords.x = xTC;
+		v.texCoords.y = yTC;
+		v.color = c;
+	}
+};
+
+/**
+ * A particle system whose update, death and build steps are fixed at compile time,
+ * so that they get inlined into its loops instead of being called virtually per particle.
+ * It still is a ParticleSystem, the virtual functions are only called once per system.
+ */
+template <class UpdatePolicy, class DeathPolicy = ParticlePolicies::DieOfAge, class BuildPolicy = ParticlePolicies::BuildSprite>
+class ParticleSystemT : public ParticleSystem
+{
+public:
+	ParticleSystemT(unsigned int particleAmount = 5000) : ParticleSystem(particleAmount)
+	{
+		ParticleSystem::setBuilder(BuildPolicy::runtime());
+	}
+
+	void setBuilder(ParticleBuilder &builder) override
+	{
+		throw "This particle system's builder is fixed at compile time!!";
+	}
+
+	bool isDead(unsigned int p) const override final
+	{
+		return DeathPolicy::isDead(m_particles, p);
+	}
+
+protected:
+	void updateParticles(float deltaTime, unsigned int begin, unsigned int end) override final
+	{
+		UpdatePolicy::update(*this, m_particles.from(begin), end - begin, deltaTime);
+	}
+
+	void removeDead() override final
+	{
+		for (unsigned int p = 0; p < m_aliveCount;)
+		{
+			if (DeathPolicy::isDead(m_particles, p)) kill(p);
+			else ++p;
+		}
+	}
+
+	void buildVertices(unsigned int begin, unsigned int end, sf::Vertex *vertices) const override final
+	{
+		BuildPolicy::build(*this, m_particles.from(begin), end - begin, vertices);
+	}
+};
+
+#endif // PARTICLESYSTEMT_H
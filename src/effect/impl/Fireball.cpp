@@ -3,7 +3,47 @@
  *
  * @date       March 2, 2015
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             The particles are updated in passes over the particle arrays.
+ *
+ *             October 18, 2026
+ *             The particle update is a policy inlined into the system's loops.
+ *
+ *             October 18, 2026
+ *             The particles steer by rotating their direction to the emitter, without any trigonometric calls.
+ *
+ *             October 18, 2026
+ *             Safe to update off the rendering thread, the shader is only touched when drawing.
+ *
+ *             October 18, 2026
+ *             Can be reset to be reused, the swoosh only plays while the fireball is being updated.
+ *
+ *             October 18, 2026
+ *             The sound, texture and shader come from the resource cache and are shared by every fireball.
+ *
+ *             October 18, 2026
+ *             The wave is packed into the vertices instead of the shader's parameters, fireballs get drawn in one batch.
+ *
+ *             October 18, 2026
+ *             Builds a single vertex per particle when a geometry shader can turn it into a quad.
+ *
+ *             October 18, 2026
+ *             The wave is accounted for when culling.
+ *
+ *             October 18, 2026
+ *             The shader is set up once, not while drawing, the frame might be drawn on the render thread.
+ *
+ *             October 18, 2026
+ *             Sprites and points are two build policies, each one its own fireball, picked when creating one.
+ *
+ *             October 18, 2026
+ *             The shared texture and shader are set up by Prepare, constructing a fireball no longer touches them.
+ *
+ *             October 18, 2026
+ *             Fireballs fall back to sprites when the point shader didn't compile.
+ *
+ *             October 18, 2026
+ *             The swoosh is played and adjusted on the main thread, after the update worked out its volume.
  *
  * @designer   Melvin Loho
  *
@@ -13,50 +53,100 @@
  */
 
 #include "Fireball.h"
+#include "FireballSteering.h"
+#include "../../core/ResourceCache.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <iostream>
 
-bool Fireball::staticResourceLoadLock = false;
-sf::SoundBuffer Fireball::sb;
-sf::Texture Fireball::particleTexture;
+bool Fireball::pointsUsable = false;
+
+ParticleSystem* Fireball::Create()
+{
+	if (pointsUsable) return new FireballT<FireballPoint>();
+
+	return new FireballT<FireballSprite>();
+}
 
-Fireball::Fireball() : ParticleSystem(5000)
+void Fireball::Prepare()
 {
-	lifeTimeMin = sf::seconds(0.f), lifeTimeMax = sf::seconds(2.f);
-	velMin = 3, velMax = 30, angleOffsetMin = -1.0f, angleOffsetMax = 1.0f;
-	spawnRate = 10;
-	colorBegin = sf::Color::Green;
-	colorEnd = sf::Color(128, 240, 255);
-	alphaMin = alphaMax = 128 / 10;
-
-	if (!staticResourceLoadLock)
+	std::shared_ptr<sf::Texture> particleTexture = ResourceCache::GetTexture("Data/textures/particle_1.tga");
+	std::shared_ptr<sf::Shader> shader_shake;
+
+	particleTexture->setSmooth(true);
+
+	pointsUsable = false;
+
+	if (sf::Shader::isGeometryAvailable())
 	{
-		staticResourceLoadLock = true;
+		shader_shake = ResourceCache::GetShader("Data/shaders/wave_point.vert", "Data/shaders/wave_point.geom", "Data/shaders/wave_point.frag");
+
+		// a driver can have geometry shaders and still reject the profile these ones ask for
+		pointsUsable = shader_shake->getNativeHandle() != 0;
 
-		sb.loadFromFile("Data/audio/SWOOSH_loop.wav");
-		particleTexture.loadFromFile("Data/textures/particle_1.tga");
+		if (!pointsUsable) std::cerr << "The fireballs' point shader did not compile, they are drawn as sprites" << std::endl;
 	}
 
-	swoosh.setBuffer(sb);
+	if (!pointsUsable) shader_shake = ResourceCache::GetShader("Data/shaders/wave.vert", sf::Shader::Vertex);
+
+	// the same for every fireball, whatever differs between them is in their vertices
+	shader_shake->setUniform("texture_size", sf::Vector2f(particleTexture->getSize()));
+	if (pointsUsable) shader_shake->setUniform("particle_texture", sf::Shader::CurrentTexture);
+}
+
+template <class BuildPolicy>
+FireballT<BuildPolicy>::FireballT() : ParticleSystemT<FireballMotion, ParticlePolicies::DieOfAge, BuildPolicy>(5000),
+	sb(ResourceCache::GetSoundBuffer("Data/audio/SWOOSH_loop.wav")),
+	particleTexture(ResourceCache::GetTexture("Data/textures/particle_1.tga")),
+	shader_shake(BuildPolicy::Type == sf::PrimitiveType::Points
+		? ResourceCache::GetShader("Data/shaders/wave_point.vert", "Data/shaders/wave_point.geom", "Data/shaders/wave_point.frag")
+		: ResourceCache::GetShader("Data/shaders/wave.vert", sf::Shader::Vertex))
+{
+	swoosh.setBuffer(*sb);
 	swoosh.setLoop(true);
-	swoosh.setVolume(0);
-	swoosh.play();
 
-	shader_shake.loadFromFile("Data/shaders/wave.vert", sf::Shader::Vertex);
+	// both already set up by Prepare
+	this->setTexture(*particleTexture);
 
-	particleTexture.setSmooth(true);
-	setTexture(particleTexture);
+	reset();
 }
 
-Fireball::~Fireball()
+template <class BuildPolicy>
+FireballT<BuildPolicy>::~FireballT()
 {
 	swoosh.stop();
 }
 
-void Fireball::update(const sf::Time& deltaTime)
+template <class BuildPolicy>
+void FireballT<BuildPolicy>::reset()
 {
-	ParticleSystem::update(deltaTime);
+	ParticleSystem::reset();
 
+	this->lifeTimeMin = sf::seconds(0.f), this->lifeTimeMax = sf::seconds(2.f);
+	this->velMin = 3, this->velMax = 30, this->angleOffsetMin = -1.0f, this->angleOffsetMax = 1.0f;
+	this->spawnRate = 10;
+	this->colorBegin = sf::Color::Green;
+	this->colorEnd = sf::Color(128, 240, 255);
+	this->alphaMin = this->alphaMax = 128 / 10;
+
+	lastEmitterPos = this->emitterPos;
+
+	// silent until it gets updated again
+	swoosh.stop();
+	swoosh.setVolume(0);
+	swooshVolume = 0.f;
+	swooshStoppedLen = 0;
+
+	wavePhase = 0.f;
+	waveAmp = sf::Vector2f(0.f, 0.f);
+}
+
+template <class BuildPolicy>
+void FireballT<BuildPolicy>::updateEmitter(const sf::Time& deltaTime)
+{
+	const sf::Vector2f &emitterPos = this->emitterPos;
 	sf::Vector2f delta(abs(emitterPos.x - lastEmitterPos.x), abs(emitterPos.y - lastEmitterPos.y));
 	float magnitude = sqrt(delta.x * delta.x + delta.y * delta.y);
 
@@ -80,47 +170,167 @@ void Fireball::update(const sf::Time& deltaTime)
 		wavePhase = 0;
 	}
 
-	swoosh.setPitch(swooshVolume / 100);
-	swoosh.setVolume(swooshVolume);
-
 	++wavePhase;
 	magnitude = std::min(magnitude / 5, 15.f);
 	waveAmp.x = waveAmp.y = magnitude;
 
-	shader_shake.setParameter("wave_phase", wavePhase);
-	shader_shake.setParameter("wave_amplitude", waveAmp);
-
 	lastEmitterPos = emitterPos;
 }
 
-void Fireball::updateParticle(const sf::Time &deltaTime, ParticleSystem::Particle &p)
+template <class BuildPolicy>
+void FireballT<BuildPolicy>::applyEmitter()
+{
+	// the volume worked out by the update, the sound is only touched from the main thread
+	if (swoosh.getStatus() != sf::Sound::Playing) swoosh.play();
+
+	swoosh.setPitch(swooshVolume / 100);
+	swoosh.setVolume(swooshVolume);
+}
+
+// Fades a colour channel of every particle from begin to end over its lifetime
+static void lerpChannel(sf::Uint8 *channel, const float *lifetime, unsigned int count, float invLifeTimeMax, float end, float begin)
+{
+	const float span = begin - end;
+
+	for (unsigned int p = 0; p < count; ++p)
+	{
+		const float ratio = std::max(lifetime[p] * invLifeTimeMax, 0.f);
+
+		// through int, the compiler can't vectorize a float to Uint8 conversion
+		channel[p] = static_cast<sf::Uint8>(static_cast<int>(end + ratio * span));
+	}
+}
+
+void FireballMotion::update(const ParticleSystem &ps, const ParticleSystem::Particles &particles, unsigned int count, float deltaTime)
 {
-	p.lifetime -= deltaTime;
+	float *posX = particles.posX, *posY = particles.posY;
+	float *lifetime = particles.lifetime, *vel = particles.vel;
+	const float *angleOffset = particles.angleOffset;
+	sf::Uint8 *a = particles.a;
 
-	if (isDead(p)) return;
+	const sf::Vector2f &emitterPos = ps.emitterPos;
+	const float invLifeTimeMax = 1.f / ps.lifeTimeMax.asSeconds();
+	const float alphaScale = ps.velMax * ps.alphaMax;
 
-	float currcalc_lifeTimeRatio = p.lifetime / lifeTimeMax;
-	sf::Vector2f currcalc_deltaPos = emitterPos - p.pos;
+	// AGE
 
-	p.clr.r = static_cast<sf::Uint8>(colorEnd.r + currcalc_lifeTimeRatio * (colorBegin.r - colorEnd.r));
-	p.clr.g = static_cast<sf::Uint8>(colorEnd.g + currcalc_lifeTimeRatio * (colorBegin.g - colorEnd.g));
-	p.clr.b = static_cast<sf::Uint8>(colorEnd.b + currcalc_lifeTimeRatio * (colorBegin.b - colorEnd.b));
-	p.clr.a = static_cast<sf::Uint8>(velMax / p.vel * alphaMax);
+	for (unsigned int p = 0; p < count; ++p)
+	{
+		lifetime[p] -= deltaTime;
+	}
+
+	// COLOUR (one array at a time and branch-free, dead particles are never built anyway)
 
-	if (abs(currcalc_deltaPos.x) > 0.f || abs(currcalc_deltaPos.y) > 0.f)
+	lerpChannel(particles.r, lifetime, count, invLifeTimeMax, ps.colorEnd.r, ps.colorBegin.r);
+	lerpChannel(particles.g, lifetime, count, invLifeTimeMax, ps.colorEnd.g, ps.colorBegin.g);
+	lerpChannel(particles.b, lifetime, count, invLifeTimeMax, ps.colorEnd.b, ps.colorBegin.b);
+
+	// slowed down to (next to) nothing, a particle is as opaque as it gets, the division is clamped before narrowing
+	for (unsigned int p = 0; p < count; ++p)
 	{
-		p.vel = p.vel * currcalc_lifeTimeRatio + p.vel * 0.15f;
+		const float alpha = std::min(alphaScale / std::max(vel[p], FLT_MIN), 255.f);
 
-		float currcalc_theta_rad = atan2(currcalc_deltaPos.y, currcalc_deltaPos.x);
-		p.pos.x += p.vel * cos(currcalc_theta_rad + p.angleOffset * currcalc_lifeTimeRatio);
-		p.pos.y += p.vel * sin(currcalc_theta_rad + p.angleOffset * currcalc_lifeTimeRatio);
+		a[p] = static_cast<sf::Uint8>(static_cast<int>(alpha));
 	}
+
+	// MOVEMENT
+
+	steer(posX, posY, vel, lifetime, angleOffset, count, emitterPos.x, emitterPos.y, invLifeTimeMax);
 }
 
-void Fireball::draw(Renderer& renderer, sf::RenderStates states) const
+// The wave amplitude goes into the vertices in steps of 1/64th of a pixel, 10 bits per axis
+static const float WAVE_AMPLITUDE_STEPS = 64.f;
+static const int WAVE_AMPLITUDE_MAX = 1023;
+
+// Both amplitudes and the corner of the texture (in the two lowest bits) in a float, small enough to stay exact
+static inline float packWave(const sf::Vector2f &waveAmp)
+{
+	const int x = std::max(0, std::min(static_cast<int>(waveAmp.x * WAVE_AMPLITUDE_STEPS + 0.5f), WAVE_AMPLITUDE_MAX));
+	const int y = std::max(0, std::min(static_cast<int>(waveAmp.y * WAVE_AMPLITUDE_STEPS + 0.5f), WAVE_AMPLITUDE_MAX));
+
+	return static_cast<float>((x + y * (WAVE_AMPLITUDE_MAX + 1)) * 4);
+}
+
+// As points, the amplitudes only get 6 bits per axis (steps of 1/4th of a pixel) to leave room for the size
+static const float POINT_WAVE_AMPLITUDE_STEPS = 4.f;
+static const int POINT_WAVE_AMPLITUDE_MAX = 63;
+// Largest fraction that doesn't round up into the amplitudes (12 bits left after the integer part)
+static const float POINT_SIZE_MAX = 1.f - 1.f / 4096.f;
+
+static inline float packPointWave(const sf::Vector2f &waveAmp)
 {
-	states.shader = &shader_shake;
+	const int x = std::max(0, std::min(static_cast<int>(waveAmp.x * POINT_WAVE_AMPLITUDE_STEPS + 0.5f), POINT_WAVE_AMPLITUDE_MAX));
+	const int y = std::max(0, std::min(static_cast<int>(waveAmp.y * POINT_WAVE_AMPLITUDE_STEPS + 0.5f), POINT_WAVE_AMPLITUDE_MAX));
+
+	return static_cast<float>(x + y * (POINT_WAVE_AMPLITUDE_MAX + 1));
+}
+
+void FireballPoint::build(const ParticleSystem &ps, const ParticleSystem::Particles &particles, unsigned int count, sf::Vertex *vertices)
+{
+	const FireballT<FireballPoint> &fireball = static_cast<const FireballT<FireballPoint>&>(ps);
+
+	// texCoords.x is the packed wave plus the size (as a fraction of the texture's), texCoords.y the phase
+	const float invLifeTimeMax = 1.f / ps.lifeTimeMax.asSeconds();
+	const float wave = packPointWave(fireball.waveAmp);
+	const float phase = fireball.wavePhase;
+
+	for (unsigned int p = 0; p < count; ++p)
+	{
+		const float size = std::min(particles.lifetime[p] * invLifeTimeMax, POINT_SIZE_MAX);
+
+		ParticlePolicies::setVertex(vertices[p], particles.posX[p], particles.posY[p], wave + size, phase,
+			sf::Color(particles.r[p], particles.g[p], particles.b[p], particles.a[p]));
+	}
+}
+
+void FireballSprite::build(const ParticleSystem &ps, const ParticleSystem::Particles &particles, unsigned int count, sf::Vertex *vertices)
+{
+	const FireballT<FireballSprite> &fireball = static_cast<const FireballT<FireballSprite>&>(ps);
+
+	const float lifeTimeMax = ps.lifeTimeMax.asSeconds();
+	const sf::Vector2f halfSize = ps.getTextureSize() * 0.5f;
+	// texCoords.x is the packed wave plus the corner, texCoords.y the phase
+	const float wave = packWave(fireball.waveAmp);
+	const float phase = fireball.wavePhase;
+	unsigned int vertexCount = 0;
+
+	for (unsigned int p = 0; p < count; ++p)
+	{
+		const sf::Vector2f pos(particles.posX[p], particles.posY[p]);
+		const sf::Color color(particles.r[p], particles.g[p], particles.b[p], particles.a[p]);
+		const sf::Vector2f size = (particles.lifetime[p] / lifeTimeMax) * halfSize;
+		sf::Vertex *duplicateVertex1, *duplicateVertex2;
+
+		/* 0 */ ParticlePolicies::setVertex(vertices[vertexCount++], pos.x - size.x, pos.y - size.y, wave, phase, color);
+
+		duplicateVertex1 = &vertices[vertexCount++];
+		duplicateVertex2 = &vertices[vertexCount++];
+
+		/* 1 */ ParticlePolicies::setVertex(*duplicateVertex1, pos.x - size.x, pos.y + size.y, wave + 2.f, phase, color);
+		/* 2 */ ParticlePolicies::setVertex(*duplicateVertex2, pos.x + size.x, pos.y - size.y, wave + 1.f, phase, color);
+
+		/* 1 */ vertices[vertexCount++] = *duplicateVertex1;
+		/* 2 */ vertices[vertexCount++] = *duplicateVertex2;
+		/* 3 */ ParticlePolicies::setVertex(vertices[vertexCount++], pos.x + size.x, pos.y + size.y, wave + 3.f, phase, color);
+	}
+}
+
+template <class BuildPolicy>
+float FireballT<BuildPolicy>::getCullMargin() const
+{
+	// the shader moves the particles by up to 1.3 times the amplitude of the wave
+	return ParticleSystem::getCullMargin() + 1.3f * std::max(waveAmp.x, waveAmp.y);
+}
+
+template <class BuildPolicy>
+void FireballT<BuildPolicy>::draw(Renderer& renderer, sf::RenderStates states) const
+{
+	states.shader = shader_shake.get();
 	states.blendMode = sf::BlendAdd;
 
 	ParticleSystem::draw(renderer, states);
 }
+
+// the only fireballs there are
+template class FireballT<FireballSprite>;
+template class FireballT<FireballPoint>;
@@ -1,29 +1,64 @@
 #ifndef PS_FIREBALL_H
 #define PS_FIREBALL_H
 
+#include <memory>
 #include <SFML/Audio.hpp>
-#include "../ParticleSystem.h"
+#include "../ParticleSystemT.h"
 
-class Fireball : public ParticleSystem
+// Particles swirling towards the emitter while fading out
+struct FireballMotion
 {
+	static void update(const ParticleSystem &ps, const ParticleSystem::Particles &particles, unsigned int count, float deltaTime);
+};
+
+// Sprites carrying the wave of their fireball in their texture coordinates, so that fireballs can be batched
+struct FireballSprite
+{
+	static const sf::PrimitiveType Type = sf::PrimitiveType::Triangles;
+	static const sf::Uint8 Count = SPRITE_VERTICES;
+
+	static void build(const ParticleSystem &ps, const ParticleSystem::Particles &particles, unsigned int count, sf::Vertex *vertices);
+
+	static inline ParticleBuilder &runtime() { return ParticleBuilders::pbSprite; }
+};
+
+// A single vertex per particle, carrying its wave and size, that a geometry shader expands into a sprite
+struct FireballPoint
+{
+	static const sf::PrimitiveType Type = sf::PrimitiveType::Points;
+	static const sf::Uint8 Count = 1;
+
+	static void build(const ParticleSystem &ps, const ParticleSystem::Particles &particles, unsigned int count, sf::Vertex *vertices);
+
+	static inline ParticleBuilder &runtime() { return ParticleBuilders::pbPoint; }
+};
+
+/**
+ * A fireball, built by either of the build policies above (each one with its own shader).
+ * Only instantiated with FireballSprite and FireballPoint, see Fireball::Create.
+ */
+template <class BuildPolicy>
+class FireballT : public ParticleSystemT<FireballMotion, ParticlePolicies::DieOfAge, BuildPolicy>
+{
+	friend struct FireballSprite;
+	friend struct FireballPoint;
+
 public:
-	Fireball();
-	~Fireball();
+	FireballT();
+	~FireballT();
 
-	void update(const sf::Time& deltaTime) override;
+	void reset() override;
+	void applyEmitter() override;
 
 protected:
-	void updateParticle(const sf::Time &deltaTime, ParticleSystem::Particle &p) override;
+	void updateEmitter(const sf::Time& deltaTime) override;
+	float getCullMargin() const override;
 	void draw(Renderer& renderer, sf::RenderStates states) const override;
 
 private:
-	// static resources>
-
-	static bool staticResourceLoadLock;
-	static sf::SoundBuffer sb;
-	static sf::Texture particleTexture;
-
-	// <static resources
+	// shared with every other fireball
+	std::shared_ptr<sf::SoundBuffer> sb;
+	std::shared_ptr<sf::Texture> particleTexture;
 
 	sf::Vector2f lastEmitterPos;
 
@@ -34,7 +69,20 @@ private:
 	sf::Vector2f waveAmp;
 
 	sf::Sound swoosh;
-	sf::Shader shader_shake;
+	// set up by Fireball::Prepare, the rendering thread might be drawing with it by the time a fireball gets constructed
+	std::shared_ptr<sf::Shader> shader_shake;
+};
+
+struct Fireball
+{
+	// Built as points when Prepare got the point shader going, as sprites otherwise
+	static ParticleSystem* Create();
+	// Sets up the texture and shader shared by every fireball, to be done on the rendering thread (or before it starts)
+	static void Prepare();
+
+private:
+	// Whether geometry shaders are available and the point shader compiled
+	static bool pointsUsable;
 };
 
 #endif // PS_FIREBALL_H
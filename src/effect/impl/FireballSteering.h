@@ -0,0 +1,57 @@
+#ifndef PS_FIREBALL_STEERING_H
+#define PS_FIREBALL_STEERING_H
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// The kernels moving fireball particles, kept apart from SFML so that they can be checked on their own
+
+// Sine and cosine of an angle within [-pi, pi] by polynomials, off by at most 4e-6 from std::sin and std::cos
+static inline void sinCos(float x, float &sinX, float &cosX)
+{
+	const float halfPi = 1.57079633f, pi = 3.14159265f;
+
+	// fold the angle into [-pi/2, pi/2], where the series converge quickly, the cosine flips sign
+	// (both folds are computed up front so that only selects are left for the vectorizer)
+	const float above = pi - x, below = -pi - x;
+	const float folded = x > halfPi ? above : (x < -halfPi ? below : x);
+	const float cosSign = (x > halfPi || x < -halfPi) ? -1.f : 1.f;
+	const float x2 = folded * folded;
+
+	sinX = folded * (1.f + x2 * (-1.f / 6 + x2 * (1.f / 120 + x2 * (-1.f / 5040 + x2 * (1.f / 362880)))));
+	cosX = cosSign * (1.f + x2 * (-1.f / 2 + x2 * (1.f / 24 + x2 * (-1.f / 720 + x2 * (1.f / 40320 + x2 * (-1.f / 3628800))))));
+}
+
+// Moves every particle towards the emitter, turned by its angle offset
+// (the arrays never overlap, telling the compiler so lets it vectorize the loop)
+static inline void steer(float *__restrict posX, float *__restrict posY, float *__restrict vel,
+	const float *__restrict lifetime, const float *__restrict angleOffset, unsigned int count,
+	float emitterX, float emitterY, float invLifeTimeMax)
+{
+	for (unsigned int p = 0; p < count; ++p)
+	{
+		const float dx = emitterX - posX[p];
+		const float dy = emitterY - posY[p];
+		const float distSq = dx * dx + dy * dy;
+
+		// unit direction to the emitter, (0, 0) for a particle sitting on it
+		const float invDist = 1.f / std::sqrt(std::max(distSq, FLT_MIN));
+		const float dirX = dx * invDist, dirY = dy * invDist;
+
+		// rotating the direction stands in for atan2 followed by cos/sin of the sum
+		const float ratio = lifetime[p] * invLifeTimeMax;
+		float sinOffset, cosOffset;
+		sinCos(angleOffset[p] * ratio, sinOffset, cosOffset);
+
+		// a particle on the emitter keeps its velocity, like it did when it was skipped
+		const float slowdown = ratio + 0.15f;
+		const float speed = vel[p] * (distSq > 0.f ? slowdown : 1.f);
+
+		vel[p] = speed;
+		posX[p] += speed * (dirX * cosOffset - dirY * sinOffset);
+		posY[p] += speed * (dirY * cosOffset + dirX * sinOffset);
+	}
+}
+
+#endif // PS_FIREBALL_STEERING_H
@@ -3,7 +3,14 @@
  *
  * @date       2013-??-??
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Owns the job system that the scenes spread their work over.
+ *
+ *             October 18, 2026
+ *             Can draw the frames on a render thread, pipelined with the updates of the next frame.
+ *
+ *             October 18, 2026
+ *             The phases of the game loop are profiled.
  *
  * @designer   Melvin Loho
  *
@@ -16,12 +23,15 @@
  */
 
 #include "AppWindow.h"
+#include "../core/Profiler.h"
+#include "../core/Renderer.h"
 
 #include <iostream>
 
 const sf::Vector2i AppWindow::DEFAULT_RESOLUTION(1366, 768);
 const sf::Keyboard::Key AppWindow::DEFAULT_KEY_FULLSCREEN = sf::Keyboard::F11;
 const sf::Keyboard::Key AppWindow::DEFAULT_KEY_SCREENSHOT = sf::Keyboard::F12;
+const sf::Keyboard::Key AppWindow::DEFAULT_KEY_TRACE = sf::Keyboard::F10;
 
 AppWindow::AppWindow() :
 	m_lastWindowSize(),
@@ -30,13 +40,18 @@ AppWindow::AppWindow() :
 	m_isFullscreen(false),
 	m_isVSync(false),
 	m_isRunning(false),
-	m_emptyScene(Scene::Create<Scene>(*this))
+	m_emptyScene(Scene::Create<Scene>(*this)),
+	m_renderThreaded(false),
+	m_renderRunning(false),
+	m_renderBusy(false)
 {
 	m_windowScenes.push_back(m_emptyScene);
 }
 
 AppWindow::~AppWindow()
-{}
+{
+	stopRenderThread();
+}
 
 void AppWindow::create(
 	const std::string &name,
@@ -118,8 +133,7 @@ void AppWindow::removeScene(Scene::ID id) {
 	m_windowScenes.back()->onload();
 	updateTitle();
 
-	clear();
-	display();
+	present();
 
 	std::cout
 		<< "Loaded: "
@@ -133,6 +147,14 @@ int AppWindow::getFPS() const {
 	return (int)(1 / m_elapsedTime.asSeconds());
 }
 
+sf::Time AppWindow::getFrameTime() const {
+	return m_elapsedTime;
+}
+
+JobSystem& AppWindow::getJobs() {
+	return m_jobs;
+}
+
 sf::View AppWindow::getCurrentView() const {
 	sf::Vector2u size = getSize();
 	return sf::View(
@@ -179,9 +201,168 @@ void AppWindow::updateTitle() {
 }
 
 void AppWindow::toggleFullScreen() {
+	// the window gets a new context, the render thread lets go of the old one first
+	const bool restartRenderThread = m_renderThread.joinable();
+	if (restartRenderThread) stopRenderThread();
+
 	if (!m_isFullscreen) m_lastWindowSize = getSize();
 	m_isFullscreen = !m_isFullscreen;
 	create(getName(), m_lastWindowSize.x, m_lastWindowSize.y, m_autoResolution, m_isFullscreen ? sf::Style::Fullscreen : m_lastWindowStyle, sf::ContextSettings(), m_isVSync);
+
+	if (restartRenderThread) startRenderThread();
+}
+
+void AppWindow::setRenderThreaded(bool enabled) {
+	m_renderThreaded = enabled;
+
+	if (m_isRunning) {
+		if (enabled) startRenderThread();
+		else stopRenderThread();
+	}
+}
+
+bool AppWindow::isRenderThreaded() const {
+	return m_renderThreaded;
+}
+
+void AppWindow::present(Renderer& renderer)
+{
+	if (!m_renderThread.joinable())
+	{
+		sf::Clock clock;
+
+		renderer.swapFrames(false);
+		renderer.drawFrame();
+		display();
+
+		m_renderTime = clock.getElapsedTime();
+		m_presentWaitTime = sf::Time::Zero;
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(m_renderMutex);
+
+	// one frame in flight, the renderer's other frame is the one being drawn
+	sf::Clock clock;
+	waitForRenderThread(lock);
+	m_presentWaitTime = clock.getElapsedTime();
+	m_renderTime = m_renderTimeDrawn;
+
+	renderer.swapFrames(true);
+
+	m_renderJobs.push_back([this, &renderer]
+	{
+		sf::Clock clock;
+
+		renderer.drawFrame();
+		display();
+
+		m_renderTimeDrawn = clock.getElapsedTime();
+	});
+
+	m_renderWakeup.notify_one();
+}
+
+void AppWindow::present()
+{
+	runOnRenderThread([this]
+	{
+		clear();
+		display();
+	});
+}
+
+void AppWindow::runOnRenderThread(std::function<void()> job)
+{
+	if (!m_renderThread.joinable())
+	{
+		job();
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(m_renderMutex);
+
+	m_renderJobs.push_back(job);
+	m_renderWakeup.notify_one();
+
+	waitForRenderThread(lock);
+}
+
+sf::Time AppWindow::getRenderTime() const {
+	return m_renderTime;
+}
+
+sf::Time AppWindow::getPresentWaitTime() const {
+	return m_presentWaitTime;
+}
+
+void AppWindow::close() {
+	stopRenderThread();
+	sf::RenderWindow::close();
+}
+
+void AppWindow::onResize() {
+	// the passes set their own views, the default one is left alone while another thread draws
+	if (!m_renderThread.joinable()) sf::RenderWindow::onResize();
+}
+
+void AppWindow::startRenderThread()
+{
+	if (m_renderThread.joinable()) return;
+
+	// a context can only be active on one thread at a time
+	setActive(false);
+
+	m_renderRunning = true;
+	m_renderThread = std::thread(&AppWindow::renderThread, this);
+}
+
+void AppWindow::stopRenderThread()
+{
+	if (!m_renderThread.joinable()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_renderMutex);
+		m_renderRunning = false;
+	}
+
+	m_renderWakeup.notify_one();
+	m_renderThread.join();
+
+	setActive(true);
+}
+
+void AppWindow::renderThread()
+{
+	setActive(true);
+
+	std::unique_lock<std::mutex> lock(m_renderMutex);
+
+	// the jobs left get done before stopping
+	while (true)
+	{
+		m_renderWakeup.wait(lock, [this] { return !m_renderJobs.empty() || !m_renderRunning; });
+
+		if (m_renderJobs.empty()) break;
+
+		std::function<void()> job = m_renderJobs.front();
+		m_renderJobs.pop_front();
+		m_renderBusy = true;
+
+		lock.unlock();
+		job();
+		lock.lock();
+
+		m_renderBusy = false;
+		m_renderDone.notify_all();
+	}
+
+	setActive(false);
+}
+
+void AppWindow::waitForRenderThread(std::unique_lock<std::mutex>& lock)
+{
+	m_renderDone.wait(lock, [this] { return m_renderJobs.empty() && !m_renderBusy; });
 }
 
 // Uses:
@@ -224,6 +405,8 @@ void AppWindow::run() {
 	{
 		m_isRunning = true;
 
+		if (m_renderThreaded) startRenderThread();
+
 		sf::Clock clock;
 		sf::Event event;
 
@@ -237,50 +420,67 @@ void AppWindow::run() {
 			m_timeSinceLastUpdate += m_elapsedTime;
 
 			// CHECK FOR EVENTS
-			while (pollEvent(event))
 			{
-				if (!eventTypesToIgnoreOnce.empty())
-				{
-					skipCurrentEvent = false;
+				Profiler::Scope events(Profiler::EVENTS);
 
-					for (std::vector<sf::Event::EventType>::iterator it = eventTypesToIgnoreOnce.begin(); it != eventTypesToIgnoreOnce.end();)
+				while (pollEvent(event))
+				{
+					if (!eventTypesToIgnoreOnce.empty())
 					{
-						if (*it == event.type)
+						skipCurrentEvent = false;
+
+						for (std::vector<sf::Event::EventType>::iterator it = eventTypesToIgnoreOnce.begin(); it != eventTypesToIgnoreOnce.end();)
 						{
-							eventTypesToIgnoreOnce.erase(it);
-							skipCurrentEvent = true;
-							break;
+							if (*it == event.type)
+							{
+								eventTypesToIgnoreOnce.erase(it);
+								skipCurrentEvent = true;
+								break;
+							}
+							else
+							{
+								++it;
+							}
 						}
-						else
+
+						if (skipCurrentEvent)
 						{
-							++it;
+							//std::cout << "EVENT IGNORED! Type: " << event.type << std::endl;
+							continue;
 						}
 					}
 
-					if (skipCurrentEvent)
-					{
-						//std::cout << "EVENT IGNORED! Type: " << event.type << std::endl;
-						continue;
-					}
+					m_windowScenes.back()->handleEvent(event);
 				}
-
-				m_windowScenes.back()->handleEvent(event);
 			}
 
 			// TIME PER FRAME CONTROLLED LOOP
-			while (m_timeSinceLastUpdate > m_timePerFrame)
 			{
-				m_timeSinceLastUpdate -= m_timePerFrame;
+				Profiler::Scope updates(Profiler::UPDATE);
+
+				while (m_timeSinceLastUpdate > m_timePerFrame)
+				{
+					m_timeSinceLastUpdate -= m_timePerFrame;
+
+					for (Scene::Ptr s : m_windowScenes)
+						s->update(m_timePerFrame);
+				}
+			}
+
+			// RENDER (or record, for the render thread to draw while the next frame gets updated)
+			{
+				Profiler::Scope render(Profiler::RENDER);
 
 				for (Scene::Ptr s : m_windowScenes)
-					s->update(m_timePerFrame);
+					s->render();
 			}
 
-			// RENDER
-			for (Scene::Ptr s : m_windowScenes)
-				s->render();
+			// the frame zone is the time from one end of a frame to the next
+			Profiler::EndFrame();
 		}
 
+		stopRenderThread();
+
 		m_isRunning = false;
 	}
 }
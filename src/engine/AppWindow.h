@@ -1,9 +1,16 @@
 #ifndef APPWINDOW_H
 #define APPWINDOW_H
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <SFML/Graphics.hpp>
+#include "JobSystem.h"
 #include "Scene.h"
 
+class Renderer;
 class Scene;
 
 class AppWindow : public sf::RenderWindow
@@ -12,6 +19,7 @@ public:
 	static const sf::Vector2i DEFAULT_RESOLUTION;
 	static const sf::Keyboard::Key DEFAULT_KEY_FULLSCREEN;
 	static const sf::Keyboard::Key DEFAULT_KEY_SCREENSHOT;
+	static const sf::Keyboard::Key DEFAULT_KEY_TRACE;
 
 	AppWindow();
 	~AppWindow();
@@ -34,6 +42,8 @@ public:
 	void removeScene(Scene::ID id);
 
 	int getFPS() const;
+	sf::Time getFrameTime() const;
+	JobSystem& getJobs();
 	sf::View getCurrentView() const;
 	sf::Vector2i getDesktopCenter() const;
 
@@ -44,6 +54,21 @@ public:
 	void setTimePerFrame(int fps);
 	void setVerticalSyncEnabled(bool enabled);
 
+	// Draws the frames on a thread of their own (which owns the OpenGL context) while the next one is updated
+	void setRenderThreaded(bool enabled);
+	bool isRenderThreaded() const;
+	// Draws (or hands over to the render thread) the frame the renderer recorded, then displays it
+	void present(Renderer& renderer);
+	// Displays a cleared window
+	void present();
+	// Runs a job on the thread the OpenGL context is active on and waits for it
+	void runOnRenderThread(std::function<void()> job);
+	// How long the last frame took to draw, and how long presenting it waited for the one before to be drawn
+	sf::Time getRenderTime() const;
+	sf::Time getPresentWaitTime() const;
+
+	void close();
+
 	void updateTitle();
 	void toggleFullScreen();
 	void ignoreOneEvent(sf::Event::EventType eventType);
@@ -59,7 +84,15 @@ public:
 
 	void run();
 
+protected:
+	void onResize() override;
+
 private:
+	void startRenderThread();
+	void stopRenderThread();
+	void renderThread();
+	void waitForRenderThread(std::unique_lock<std::mutex>& lock);
+
 	sf::Vector2u m_lastWindowSize;
 	int m_lastWindowStyle;
 	bool m_autoResolution, m_isFullscreen, m_isVSync, m_isRunning;
@@ -71,6 +104,17 @@ private:
 	std::string m_windowName;
 	std::vector<Scene::Ptr> m_windowScenes;
 	Scene::Ptr m_emptyScene;
+
+	JobSystem m_jobs;
+
+	// RENDER THREAD
+	bool m_renderThreaded, m_renderRunning, m_renderBusy;
+	std::thread m_renderThread;
+	std::deque<std::function<void()>> m_renderJobs;
+	std::mutex m_renderMutex;
+	std::condition_variable m_renderWakeup, m_renderDone;
+	// m_renderTimeDrawn is written by the render thread, copied over when presenting
+	sf::Time m_renderTime, m_renderTimeDrawn, m_presentWaitTime;
 };
 
 #endif // APPWINDOW_H
@@ -0,0 +1,160 @@
+/**
+ * Job System.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @notes      A pool of worker threads running small jobs.
+ *             Every worker has its own queue: it takes its newest job first and,
+ *             once it runs dry, steals the oldest job of another queue.
+ *             Jobs submitted from outside of the pool go to a shared queue that every worker steals from.
+ *             Waiting on a group runs jobs instead of blocking, so jobs can submit and wait on jobs of their own.
+ */
+
+#include "JobSystem.h"
+
+#include <algorithm>
+
+static thread_local const JobSystem* CURRENT_SYSTEM = nullptr;
+static thread_local unsigned int CURRENT_WORKER = 0;
+
+unsigned int JobSystem::DefaultWorkerCount()
+{
+	unsigned int cores = std::thread::hardware_concurrency();
+
+	return cores > 1 ? cores - 1 : 1;
+}
+
+JobSystem::JobSystem(unsigned int workerCount) :
+	running(true),
+	queued(0)
+{
+	for (unsigned int i = 0; i <= workerCount; ++i) queues.push_back(new Queue());
+
+	for (unsigned int i = 0; i < workerCount; ++i) threads.emplace_back(&JobSystem::workerThread, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutexSleep);
+		running = false;
+	}
+	wakeup.notify_all();
+
+	for (std::thread& thread : threads) thread.join();
+
+	// whatever was never waited on is dropped
+	for (Queue* queue : queues) delete queue;
+}
+
+void JobSystem::run(Group& group, Job job)
+{
+	// a worker keeps its own jobs close, everyone else shares the last queue
+	Queue* queue = CURRENT_SYSTEM == this ? queues[CURRENT_WORKER] : queues.back();
+
+	++group.pending;
+	++queued;
+
+	queue->mutex.lock();
+	queue->tasks.push_back(Task{ std::move(job), &group });
+	queue->mutex.unlock();
+
+	// taking the lock orders this with a worker about to sleep, so the wakeup can't get lost
+	{ std::lock_guard<std::mutex> lock(mutexSleep); }
+	wakeup.notify_one();
+}
+
+void JobSystem::runChunked(Group& group, unsigned int count, unsigned int chunkSize, std::function<void(unsigned int begin, unsigned int end)> job)
+{
+	for (unsigned int begin = 0; begin < count; begin += chunkSize)
+	{
+		unsigned int end = std::min(begin + chunkSize, count);
+
+		run(group, [job, begin, end] { job(begin, end); });
+	}
+}
+
+void JobSystem::wait(Group& group)
+{
+	unsigned int index = CURRENT_SYSTEM == this ? CURRENT_WORKER : static_cast<unsigned int>(queues.size() - 1);
+	Task task;
+
+	while (!group.isDone())
+	{
+		if (take(index, task)) execute(task);
+		else std::this_thread::yield();
+	}
+}
+
+void JobSystem::workerThread(unsigned int index)
+{
+	CURRENT_SYSTEM = this;
+	CURRENT_WORKER = index;
+
+	Task task;
+
+	while (true)
+	{
+		if (take(index, task))
+		{
+			execute(task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(mutexSleep);
+
+		wakeup.wait(lock, [this] { return queued > 0 || !running; });
+
+		if (!running) break;
+	}
+
+	CURRENT_SYSTEM = nullptr;
+}
+
+bool JobSystem::take(unsigned int index, Task& task)
+{
+	// the newest job of its own queue first, its data is the most likely to still be in the cache
+	{
+		Queue* own = queues[index];
+		std::lock_guard<std::mutex> lock(own->mutex);
+
+		if (!own->tasks.empty())
+		{
+			task = std::move(own->tasks.back());
+			own->tasks.pop_back();
+			--queued;
+			return true;
+		}
+	}
+
+	// then the oldest job of anyone else, starting with the next queue over
+	for (size_t i = 1; i < queues.size(); ++i)
+	{
+		Queue* victim = queues[(index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(victim->mutex);
+
+		if (!victim->tasks.empty())
+		{
+			task = std::move(victim->tasks.front());
+			victim->tasks.pop_front();
+			--queued;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::execute(Task& task)
+{
+	task.job();
+	task.job = nullptr;
+
+	--task.group->pending;
+}
@@ -0,0 +1,75 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem
+{
+public:
+	typedef std::function<void()> Job;
+
+	// Jobs that are waited on together
+	class Group
+	{
+	public:
+		Group() : pending(0) {}
+
+		inline bool isDone() const { return pending == 0; }
+
+	private:
+		friend class JobSystem;
+
+		Group(const Group&) = delete;
+		Group& operator=(const Group&) = delete;
+
+		std::atomic<unsigned int> pending;
+	};
+
+	// One worker less than there are cores, the waiting thread works too
+	static unsigned int DefaultWorkerCount();
+
+	JobSystem(unsigned int workerCount = DefaultWorkerCount());
+	~JobSystem();
+
+	void run(Group& group, Job job);
+	// Splits [0, count) into ranges of at most chunkSize, each one a job
+	void runChunked(Group& group, unsigned int count, unsigned int chunkSize, std::function<void(unsigned int begin, unsigned int end)> job);
+	// Runs jobs (not necessarily the group's) until every job of the group is done
+	void wait(Group& group);
+
+	inline unsigned int getWorkerCount() const { return static_cast<unsigned int>(threads.size()); }
+
+private:
+	struct Task
+	{
+		Job job;
+		Group* group;
+	};
+
+	struct Queue
+	{
+		std::deque<Task> tasks;
+		std::mutex mutex;
+	};
+
+	void workerThread(unsigned int index);
+	bool take(unsigned int index, Task& task);
+	void execute(Task& task);
+
+	// one queue per worker plus a last one for the threads outside of the system
+	std::vector<Queue*> queues;
+	std::vector<std::thread> threads;
+
+	std::atomic<bool> running;
+	std::atomic<unsigned int> queued;
+	std::mutex mutexSleep;
+	std::condition_variable wakeup;
+};
+
+#endif // JOBSYSTEM_H
@@ -3,7 +3,11 @@
  *
  * @date       November 1, 2015
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Captures on the render thread when the window has one, the window's context lives there.
+ *
+ *             October 18, 2026
+ *             Copies the window into a texture instead of capturing it (deprecated as of SFML 2.5).
  *
  * @designer   Melvin Loho
  *
@@ -41,7 +45,18 @@ bool PrintScreen::printScreen()
 
 	while (image.loadFromFile(baseName + std::to_string(nameSuffixCount) + fileExtension)) ++nameSuffixCount;
 
-	image = appWindow.capture();
+	// through a texture, RenderWindow::capture is deprecated as of SFML 2.5
+	appWindow.runOnRenderThread([this]
+	{
+		sf::Texture texture;
+		image = sf::Image();
+
+		if (texture.create(appWindow.getSize().x, appWindow.getSize().y))
+		{
+			texture.update(appWindow);
+			image = texture.copyToImage();
+		}
+	});
 	return image.saveToFile(baseName + std::to_string(nameSuffixCount) + fileExtension);
 }
 
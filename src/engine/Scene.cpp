@@ -3,7 +3,20 @@
  *
  * @date       2013-??-??
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             The font is shared through the resource cache.
+ *
+ *             October 18, 2026
+ *             Renders by presenting through the window, which may hand the drawing to its render thread.
+ *
+ *             October 18, 2026
+ *             The log is a HUD text made of fields.
+ *
+ *             October 18, 2026
+ *             The trace key records the profiler's zones over the next frames.
+ *
+ *             October 18, 2026
+ *             The log's glyphs are prepared before anything gets laid out with them.
  *
  * @designer   Melvin Loho
  *
@@ -17,9 +30,15 @@
 #include "Scene.h"
 #include "AppWindow.h"
 #include "PrintScreen.h"
+#include "../core/Profiler.h"
+#include "../core/ResourceCache.h"
+#include "../core/object/Glyph.h"
 
 #include <iostream>
 
+// Frames recorded by a trace, a few seconds' worth
+static const unsigned int TRACE_FRAMES = 300;
+
 Scene::ID Scene::SCENE_ID = 0;
 
 Scene::Scene(AppWindow &window, const std::string &name) :
@@ -29,9 +48,13 @@ Scene::Scene(AppWindow &window, const std::string &name) :
 {
 	//std::cout << "Constructed: " << "Scene " << getID() << " \"" << getName() << "\"" << std::endl;
 
-	scene_font.loadFromFile("Data/fonts/consolas.ttf");
-	scene_log.text().setFont(scene_font);
-	scene_log.text().setCharacterSize(13);
+	scene_font = ResourceCache::GetFont("Data/fonts/consolas.ttf");
+
+	// loading glyphs changes the font's texture, which the render thread could be drawing with
+	m_window.runOnRenderThread([this] { PrepareGlyphs(*scene_font, LOG_CHARACTER_SIZE); });
+
+	scene_log.setCharacterSize(LOG_CHARACTER_SIZE);
+	scene_log.setFont(*scene_font);
 }
 
 Scene::~Scene()
@@ -90,6 +113,10 @@ void Scene::handleEvent(const sf::Event &event)
 			static PrintScreen ps(m_window);
 			ps.printScreen();
 		}
+		else if (k == AppWindow::DEFAULT_KEY_TRACE)
+		{
+			Profiler::StartTrace("Trace.json", TRACE_FRAMES);
+		}
 		//std::cout << "Scene " << getID() << "> Key pressed: " << k << std::endl;
 		break;
 
@@ -104,6 +131,5 @@ void Scene::update(const sf::Time &deltaTime)
 
 void Scene::render()
 {
-	getWindow().clear();
-	getWindow().display();
+	getWindow().present();
 }
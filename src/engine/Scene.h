@@ -3,7 +3,7 @@
 
 #include <memory>
 #include <SFML/Graphics.hpp>
-#include "../core/object/TGO.h"
+#include "../core/object/HGO.h"
 
 class AppWindow;
 
@@ -54,8 +54,11 @@ public:
 	virtual void render();
 
 protected:
-	sf::Font scene_font;
-	TGO scene_log;
+	// Of the log and anything drawn along with it, its glyphs are prepared along with the font
+	static const unsigned int LOG_CHARACTER_SIZE = 13;
+
+	std::shared_ptr<sf::Font> scene_font;
+	HGO scene_log;
 
 private:
 	static ID SCENE_ID;
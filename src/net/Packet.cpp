@@ -6,6 +6,9 @@
  * @revisions  May 21, 2015
  *             Improved packet decoding and encoding.
  *
+ *             October 18, 2026
+ *             Packets are framed by their length on the wire, TCP doesn't keep them apart.
+ *
  * @designer   Melvin Loho
  *
  * @programmer Melvin Loho
@@ -36,6 +39,30 @@ std::vector<std::string> split(const std::string &s, char delim) {
 	return elems;
 }
 
+void Packet::AppendRecord(std::string& stream, const std::string& record)
+{
+	for (int shift = (RECORD_HEADER_SIZE - 1) * 8; shift >= 0; shift -= 8)
+	{
+		stream += static_cast<char>((record.length() >> shift) & 0xFF);
+	}
+
+	stream += record;
+}
+
+bool Packet::PeekRecordLength(const std::string& stream, size_t& length)
+{
+	if (stream.length() < RECORD_HEADER_SIZE) return false;
+
+	length = 0;
+
+	for (size_t i = 0; i < RECORD_HEADER_SIZE; ++i)
+	{
+		length = (length << 8) | static_cast<unsigned char>(stream[i]);
+	}
+
+	return true;
+}
+
 Packet& Packet::combine(const Packet& other)
 {
 	this->data.reserve(this->data.size() + other.data.size());
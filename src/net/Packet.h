@@ -10,6 +10,15 @@ struct Packet
 {
 	static const size_t MAX_SIZE = 1024;
 	static const char DATA_SEPARATOR = 0x1F;
+	// Each packet sent over TCP (to a client, a server or a peer) is preceded by its length (big-endian)
+	static const size_t RECORD_HEADER_SIZE = 4;
+	// Anything longer can only be a corrupt link
+	static const size_t MAX_RECORD_SIZE = MAX_SIZE * 16;
+
+	// Appends an encoded packet to a stream, preceded by its length
+	static void AppendRecord(std::string& stream, const std::string& record);
+	// The length of the record at the start of a received stream (only if its header is all there)
+	static bool PeekRecordLength(const std::string& stream, size_t& length);
 
 	template < class T >
 	static std::string ToString(T t)
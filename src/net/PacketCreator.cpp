@@ -24,7 +24,9 @@ PacketCreator& PacketCreator::Create()
 
 Packet PacketCreator::P_Init(
 	const ClientParams& clientParams,
-	const Screen* playerScreen)
+	const Screen* playerScreen,
+	const sf::Uint32 sessionToken,
+	const WallID wallID)
 {
 	Packet p;
 	p.type = P_INIT;
@@ -36,6 +38,9 @@ Packet PacketCreator::P_Init(
 	p.add(playerScreen->size.x); //3
 	p.add(playerScreen->size.y); //4
 
+	p.add(sessionToken); //5
+	p.add(wallID); //6
+
 	return p;
 }
 
@@ -114,3 +119,25 @@ Packet PacketCreator::P_Move(const sf::Vector2i delta)
 
 	return p;
 }
+
+Packet PacketCreator::P_Peer(const WallID wallID, const Cross side)
+{
+	Packet p;
+	p.type = P_PEER;
+
+	p.add(wallID); //0
+	p.add(static_cast<int>(side)); //1
+
+	return p;
+}
+
+Packet PacketCreator::P_Relay(const Packet& packet)
+{
+	Packet p;
+	p.type = P_RELAY;
+
+	p.add(static_cast<int>(packet.type)); //0
+	p.combine(packet); //1..
+
+	return p;
+}
@@ -13,7 +13,9 @@ public:
 	Packet P_Init
 		(
 			const ClientParams& clientParams,
-			const Screen* playerScreen
+			const Screen* playerScreen,
+			const sf::Uint32 sessionToken,
+			const WallID wallID
 			);
 
 	Packet P_New
@@ -35,6 +37,10 @@ public:
 
 	Packet P_Move(const sf::Vector2i delta);
 
+	Packet P_Peer(const WallID wallID, const Cross side);
+
+	Packet P_Relay(const Packet& packet);
+
 private:
 	PacketCreator() {}
 	~PacketCreator() {}
@@ -22,6 +22,7 @@
 // TYPEDEFS --------------------------------------------------------------------
 
 typedef sf::Uint16 EntityID;
+typedef sf::Uint16 WallID;
 
 //-----------------------------------------------------------------------------<
 
@@ -38,6 +39,10 @@ enum PacketType
 	P_SCREEN,
 
 	P_MOVE,
+
+	// server to server
+	P_PEER,
+	P_RELAY,
 };
 
 enum Cross
@@ -3,7 +3,8 @@
 *
 * @date       April 21, 2015
 *
-* @revisions
+* @revisions  October 18, 2026
+*             Packets are framed by their length, the events are handed out in the order they came in.
 *
 * @designer   Melvin Loho
 *
@@ -31,6 +32,9 @@ bool Connection::start(std::string serverIP, unsigned short port)
 
 	if (socket.connect(serverIP, port) != sf::Socket::Done) return false;
 
+	// whatever was left of the last connection is of no use
+	stream.clear();
+
 	clientThread.launch();
 
 	return true;
@@ -52,7 +56,7 @@ bool Connection::pollEvent(Event& connEvent)
 	available = !connEvents.empty();
 	if (available)
 	{
-		connEvent = connEvents.top();
+		connEvent = connEvents.front();
 		connEvents.pop();
 	}
 
@@ -63,12 +67,15 @@ bool Connection::pollEvent(Event& connEvent)
 
 void Connection::send(const Packet& p)
 {
+	std::string encoded;
+	size_t length = p.encode(encoded);
+
 	std::string toSend;
-	size_t length = p.encode(toSend);
+	Packet::AppendRecord(toSend, encoded);
 
-	socket.send(toSend.c_str(), length);
+	socket.send(toSend.c_str(), toSend.length());
 
-	std::cout << "SENT " << std::setfill('0') << std::setw(4) << length << " bytes>" << toSend << std::endl;
+	std::cout << "SENT " << std::setfill('0') << std::setw(4) << length << " bytes>" << encoded << std::endl;
 }
 
 bool Connection::isConnected()
@@ -83,7 +90,7 @@ void Connection::receiveThread()
 	mutexConnEvents.lock();
 
 	connEvents.push(Event());
-	connEvents.top().type = Event::CONNECT;
+	connEvents.back().type = Event::CONNECT;
 
 	mutexConnEvents.unlock();
 
@@ -94,19 +101,36 @@ void Connection::receiveThread()
 		size_t received;
 		if (socket.receive(buffer, Packet::MAX_SIZE, received) == sf::Socket::Done)
 		{
-			std::cout << "RECV " << std::setfill('0') << std::setw(4) << received << " bytes>";
+			// a receive can hold several packets, or only part of one
+			size_t length;
+
+			stream.append(buffer, received);
+
+			while (Packet::PeekRecordLength(stream, length) && stream.length() >= Packet::RECORD_HEADER_SIZE + length)
+			{
+				std::cout << "RECV " << std::setfill('0') << std::setw(4) << length << " bytes>";
+
+				Packet packet;
+
+				packet.decode(stream.c_str() + Packet::RECORD_HEADER_SIZE, length);
+				stream.erase(0, Packet::RECORD_HEADER_SIZE + length);
 
-			Packet packet;
+				mutexConnEvents.lock();
 
-			packet.decode(buffer, received);
+				connEvents.push(Event());
+				connEvents.back().type = Event::PACKET;
+				connEvents.back().packet = packet;
 
-			mutexConnEvents.lock();
+				mutexConnEvents.unlock();
+			}
 
-			connEvents.push(Event());
-			connEvents.top().type = Event::PACKET;
-			connEvents.top().packet = packet;
+			if (Packet::PeekRecordLength(stream, length) && length > Packet::MAX_RECORD_SIZE)
+			{
+				std::cout << "The server sent a corrupt record, disconnecting" << std::endl;
 
-			mutexConnEvents.unlock();
+				stop();
+				break;
+			}
 		}
 		else
 		{
@@ -118,7 +142,7 @@ void Connection::receiveThread()
 	mutexConnEvents.lock();
 
 	connEvents.push(Event());
-	connEvents.top().type = Event::DISCONNECT;
+	connEvents.back().type = Event::DISCONNECT;
 
 	mutexConnEvents.unlock();
 }
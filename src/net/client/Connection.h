@@ -2,7 +2,7 @@
 #define CONNECTION_H
 
 #include <mutex>
-#include <stack>
+#include <queue>
 #include <SFML/Network.hpp>
 #include "../Packet.h"
 
@@ -49,9 +49,13 @@ private:
 	sf::TcpSocket socket;
 	sf::Thread clientThread;
 
-	std::stack<Event> connEvents;
+	// in the order they happened, a reply can be several packets that depend on each other
+	std::queue<Event> connEvents;
 	std::mutex mutexConnEvents;
 
+	// received bytes that do not make up a whole packet yet
+	std::string stream;
+
 	bool is_connected;
 };
 
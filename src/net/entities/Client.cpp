@@ -3,7 +3,17 @@
  *
  * @date       October 26, 2015
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Clients can be detached and resumed with a session token.
+ *
+ *             October 18, 2026
+ *             A ClientManager is now one of the server's walls (rooms).
+ *
+ *             October 18, 2026
+ *             Neighbouring servers are represented as clients owning a proxy screen.
+ *
+ *             October 18, 2026
+ *             Session tokens can be drawn from several threads at once.
  *
  * @designer   Melvin Loho
  *
@@ -16,6 +26,7 @@
 
 #include "Client.h"
 
+#include <random>
 #include "Screen.h"
 #include "../server/Server.h"
 
@@ -29,9 +40,45 @@ bool Client::remESO(Screen* screenToRemove)
 	return true;
 }
 
-EntityID ClientManager::ID_ENTITY = 1;
+std::atomic<EntityID> ClientManager::ID_ENTITY(1);
+
+EntityID ClientManager::NewEntityID()
+{
+	return ID_ENTITY++;
+}
+
+sf::Uint32 ClientManager::NewSessionToken()
+{
+	static std::mt19937 generator(std::random_device{}());
+	// clients are created by the accept thread as well as by whoever federates the server
+	static std::mutex mutexGenerator;
+
+	std::lock_guard<std::mutex> lock(mutexGenerator);
+
+	sf::Uint32 token;
+
+	do token = generator(); while (token == Client::NO_SESSION);
 
-ClientManager::ClientManager()
+	return token;
+}
+
+Client* ClientManager::Create()
+{
+	Client* newClient = new Client();
+
+	newClient->id = NewEntityID();
+	newClient->shard = nullptr;
+	newClient->room = nullptr;
+	newClient->peer = nullptr;
+	newClient->sessionToken = NewSessionToken();
+	newClient->screenOwned = nullptr;
+	newClient->screenCurrent = nullptr;
+
+	return newClient;
+}
+
+ClientManager::ClientManager(WallID wallID) :
+	wallID(wallID)
 {}
 
 ClientManager::~ClientManager()
@@ -42,12 +89,18 @@ ClientManager::~ClientManager()
 
 Client* ClientManager::add()
 {
-	Client* newClient = *clients.insert(new Client()).first;
-	Screen* newScreen = screens.add();
+	return add(Create());
+}
+
+Client* ClientManager::add(Client* newClient)
+{
+	Screen* newScreen = newClient->peer ? screens.addProxy(newClient->peer->side) : screens.add();
+
+	clients.insert(newClient);
 
 	newScreen->owner = newClient;
 
-	newClient->id = ID_ENTITY++;
+	newClient->room = this;
 	newClient->screenOwned = newScreen;
 	newClient->screenCurrent = newClient->screenOwned;
 
@@ -84,19 +137,7 @@ bool ClientManager::rem(Client* c)
 
 ClientManager::ListIter ClientManager::rem(ListIter it)
 {
-	Client* toRemove = *it;
-
-	// remove the screen that the disconnected client owns from other clients' ESOs
-	remESOs(toRemove->screenOwned);
-
-	// delete the screen owned by the client that disconnected
-	screens.rem(toRemove->id);
-
-	// disconnect its socket
-	toRemove->socket.disconnect();
-
-	// finally delete the client object
-	delete toRemove; toRemove = nullptr;
+	destroy(*it);
 
 	return clients.erase(it);
 }
@@ -109,6 +150,10 @@ size_t ClientManager::remESOs(Screen* screenToRemove)
 	{
 		if (client->remESO(screenToRemove)) ++count;
 	}
+	for (SessionList::value_type& session : detached)
+	{
+		if (session.second->remESO(screenToRemove)) ++count;
+	}
 
 	return count;
 }
@@ -116,6 +161,82 @@ size_t ClientManager::remESOs(Screen* screenToRemove)
 void ClientManager::clear()
 {
 	for (ListIter it = clients.begin(); it != clients.end();) it = rem(it);
+	for (SessionListIter it = detached.begin(); it != detached.end();) it = remDetached(it);
 
 	clients.clear();
 }
+
+ClientManager::ListIter ClientManager::detach(ListIter it)
+{
+	Client* toDetach = *it;
+
+	// the screen stays in the chain (and in other clients' ESOs) until the session expires
+	toDetach->socket.disconnect();
+	toDetach->sessionClock.restart();
+	toDetach->shard = nullptr;
+	toDetach->outbox.clear();
+
+	detached[toDetach->sessionToken] = toDetach;
+
+	return clients.erase(it);
+}
+
+bool ClientManager::detach(Client* c)
+{
+	ListIter it = clients.find(c);
+
+	if (it == clients.end()) return false;
+
+	detach(it);
+	return true;
+}
+
+bool ClientManager::resume(Client* c, sf::Uint32 sessionToken)
+{
+	SessionListIter it = detached.find(sessionToken);
+
+	if (it == detached.end()) return false;
+
+	Client* old = it->second;
+
+	// drop the screen that was appended for the fresh connection
+	screens.rem(c->id);
+
+	// take over the detached client's place in the wall
+	c->id = old->id;
+	c->sessionToken = old->sessionToken;
+	c->params = old->params;
+	c->screenOwned = old->screenOwned;
+	c->screenCurrent = old->screenCurrent;
+	c->externalScreenOccupancies = old->externalScreenOccupancies;
+
+	c->screenOwned->owner = c;
+
+	delete old; old = nullptr;
+	detached.erase(it);
+
+	return true;
+}
+
+ClientManager::SessionListIter ClientManager::remDetached(SessionListIter it)
+{
+	destroy(it->second);
+
+	return detached.erase(it);
+}
+
+void ClientManager::destroy(Client* toRemove)
+{
+	// remove the screen that the disconnected client owns from other clients' ESOs
+	remESOs(toRemove->screenOwned);
+
+	// delete the screen owned by the client that disconnected
+	screens.rem(toRemove->id);
+
+	// disconnect its socket
+	toRemove->socket.disconnect();
+
+	// finally delete the client object
+	delete toRemove->peer; toRemove->peer = nullptr;
+	delete toRemove; toRemove = nullptr;
+}
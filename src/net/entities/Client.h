@@ -1,17 +1,34 @@
 #ifndef CLIENT_H
 #define CLIENT_H
 
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
 #include <set>
 #include <SFML/Network.hpp>
 #include "../Shared.h"
 #include "../entities/Screen.h"
 
+class ClientManager;
+class ServerShard;
+
+// A link to the server hosting the neighbouring part of the wall
+struct Peer
+{
+	// The end of this server's part of the wall that the peer is on
+	Cross side;
+	// The peer's entity IDs mapped onto this server's
+	std::map<EntityID, EntityID> ids;
+};
+
 struct Client
 {
 	typedef std::set<Screen*> ESOList;
 	typedef ESOList::iterator ESOListIter;
 
 	static const EntityID MYSELF = 0;
+	static const sf::Uint32 NO_SESSION = 0;
 
 	inline bool hasESOs()
 	{
@@ -21,6 +38,13 @@ struct Client
 	bool remESO(Screen* screenToRemove);
 
 	sf::TcpSocket socket;
+	// The server worker that owns the socket (null while detached)
+	ServerShard* shard;
+	// Encoded packets waiting to be sent by the owning shard
+	std::deque<std::string> outbox;
+	std::mutex outboxMutex;
+	// Received bytes that do not make up a whole packet yet
+	std::string stream;
 
 	Screen *screenOwned, *screenCurrent;
 	// Screens which this client is currently occupying
@@ -28,6 +52,16 @@ struct Client
 
 	EntityID id;
 	ClientParams params;
+
+	// The wall the client is on (null until its P_INIT)
+	ClientManager* room;
+	// Set when this "client" is a neighbouring server, its screen is then a proxy for the peer's screen
+	Peer* peer;
+
+	// Token handed out at P_INIT so that the client can resume this session after a reconnect
+	sf::Uint32 sessionToken;
+	// Time since the client got detached (only meaningful while detached)
+	sf::Clock sessionClock;
 };
 
 class ClientManager
@@ -35,24 +69,48 @@ class ClientManager
 public:
 	typedef std::set<Client*> List;
 	typedef List::iterator ListIter;
+	typedef std::map<sf::Uint32, Client*> SessionList;
+	typedef SessionList::iterator SessionListIter;
+
+	static Client* Create();
+	static EntityID NewEntityID();
 
-	ClientManager();
+	ClientManager(WallID wallID = 0);
 	~ClientManager();
 
 	Client* add();
+	Client* add(Client* c);
 	inline List& getList() { return clients; }
 	inline const ScreenManager& getScreenManager() { return screens; }
+	inline WallID getWallID() const { return wallID; }
+	inline std::mutex& getMutex() { return mutexState; }
+	inline bool isEmpty() const { return clients.empty() && detached.empty(); }
 	bool rem(EntityID id);
 	bool rem(Client* c);
 	ListIter rem(ListIter it);
 	size_t remESOs(Screen* screenToRemove);
 	void clear();
 
+	ListIter detach(ListIter it);
+	bool detach(Client* c);
+	bool resume(Client* c, sf::Uint32 sessionToken);
+	inline SessionList& getDetachedList() { return detached; }
+	SessionListIter remDetached(SessionListIter it);
+
 private:
-	static EntityID ID_ENTITY;
+	static std::atomic<EntityID> ID_ENTITY;
+	static sf::Uint32 NewSessionToken();
+
+	void destroy(Client* c);
+
+	const WallID wallID;
+	// Guards the wall; the server's handlers are called while holding it
+	std::mutex mutexState;
 
 	ScreenManager screens;
 	List clients;
+	// Clients that lost their connection but whose screen is kept alive for a resume
+	SessionList detached;
 };
 
 #endif // CLIENT_H
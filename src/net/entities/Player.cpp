@@ -3,7 +3,11 @@
  *
  * @date       October 21, 2015
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Removed players are pooled with their particle systems and reused.
+ *
+ *             October 18, 2026
+ *             The particle systems of the players share a scene graph.
  *
  * @designer   Melvin Loho
  *
@@ -44,6 +48,46 @@ PlayerManager::PlayerManager()
 PlayerManager::~PlayerManager()
 {
 	clear();
+
+	for (std::map<Player::ParticleSystemType, std::vector<Player*>>::value_type& pooled : pool)
+	{
+		for (Player* player : pooled.second)
+		{
+			delete player->ps;
+			delete player;
+		}
+	}
+	pool.clear();
+}
+
+Player* PlayerManager::Create(Player::ParticleSystemType pst)
+{
+	Player* newPlayer = new Player();
+
+	newPlayer->pst = pst;
+
+	switch (pst)
+	{
+	case Player::ParticleSystemType::FIREBALL:
+		newPlayer->ps = Fireball::Create();
+		break;
+
+	default:
+		newPlayer->ps = new ParticleSystem();
+	}
+
+	// over every particle system, so that the labels don't split up the batch of the players' particles
+	newPlayer->label.setLayer(1);
+	newPlayer->ps->add(newPlayer->label);
+
+	return newPlayer;
+}
+
+void PlayerManager::prewarm(Player::ParticleSystemType pst, unsigned int count)
+{
+	std::vector<Player*>& pooled = pool[pst];
+
+	while (pooled.size() < count) pooled.push_back(Create(pst));
 }
 
 Player* PlayerManager::add(EntityID id, std::string name, Player::ParticleSystemType pst, const sf::Font& font)
@@ -51,30 +95,31 @@ Player* PlayerManager::add(EntityID id, std::string name, Player::ParticleSystem
 	// try getting the player from the list
 	Player* newPlayer = get(id);
 
-	// create new player if they're not found
+	// reuse a pooled player if they're not found, create one if there are none left
 	if (!newPlayer)
 	{
-		std::cout << "Creating new player!" << std::endl;
-
-		newPlayer = *players.insert(new Player()).first;
+		std::vector<Player*>& pooled = pool[pst];
 
-		switch (pst)
+		if (pooled.empty())
 		{
-		case Player::ParticleSystemType::FIREBALL:
-			newPlayer->ps = new Fireball();
-			break;
+			std::cout << "Creating new player!" << std::endl;
 
-		default:
-			newPlayer->ps = new ParticleSystem();
+			newPlayer = Create(pst);
+		}
+		else
+		{
+			newPlayer = pooled.back();
+			pooled.pop_back();
 		}
 
-		newPlayer->ps->add(newPlayer->label);
+		players.insert(newPlayer);
+		root.add(*newPlayer->ps);
 	}
 
 	newPlayer->id = id;
 
 	newPlayer->label.text().setFont(font);
-	newPlayer->label.text().setCharacterSize(15);
+	newPlayer->label.text().setCharacterSize(Player::LABEL_CHARACTER_SIZE);
 	newPlayer->label.text().setPosition(10, -10);
 
 	newPlayer->setName(name);
@@ -121,8 +166,10 @@ PlayerManager::ListIter PlayerManager::rem(ListIter it)
 	Player* toRemove = *it;
 	EntityID id = toRemove->id;
 
-	delete toRemove->ps; toRemove->ps = nullptr;
-	delete toRemove; toRemove = nullptr;
+	// back into the pool, clean for the next player
+	root.rem(*toRemove->ps);
+	toRemove->ps->reset();
+	pool[toRemove->pst].push_back(toRemove);
 
 	std::cout << "Player removed! ID: " << id << std::endl;
 
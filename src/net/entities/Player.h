@@ -1,7 +1,9 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
+#include <map>
 #include <set>
+#include <vector>
 #include "../Shared.h"
 #include "../../core/object/TGO.h"
 
@@ -15,10 +17,14 @@ struct Player
 		FIREBALL
 	};
 
+	// The glyphs of that size have to be prepared before any label gets drawn
+	static const unsigned int LABEL_CHARACTER_SIZE = 15;
+
 	ClientParams extractClientParams() const;
 	void setName(std::string name);
 
 	EntityID id;
+	ParticleSystemType pst;
 	ParticleSystem* ps;
 	TGO label;
 };
@@ -32,15 +38,25 @@ public:
 	PlayerManager();
 	~PlayerManager();
 
+	// Builds players ahead of time so that adding them later on is cheap
+	void prewarm(Player::ParticleSystemType pst, unsigned int count);
+
 	Player* add(EntityID id, std::string name, Player::ParticleSystemType pst, const sf::Font& font);
 	Player* get(EntityID id);
 	inline List& getList() { return players; }
+	// The particle systems of the players in the list hang under it
+	inline BGO& getRoot() { return root; }
 	bool rem(EntityID id);
 	ListIter rem(ListIter it);
 	void clear();
 
 private:
+	static Player* Create(Player::ParticleSystemType pst);
+
 	List players;
+	BGO root;
+	// Removed players, kept with their particle systems to be reused
+	std::map<Player::ParticleSystemType, std::vector<Player*>> pool;
 };
 
 #endif // PLAYER_H
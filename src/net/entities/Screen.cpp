@@ -3,7 +3,8 @@
  *
  * @date       October 26, 2015
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             The ends of the list can hold proxies for the screens of a neighbouring server.
  *
  * @designer   Melvin Loho
  *
@@ -55,6 +56,8 @@ Cross Screen::checkBeyondScreens(sf::Vector2f coords) const
 ScreenManager::ScreenManager() :
 	m_first(nullptr),
 	m_last(nullptr),
+	m_proxyLeft(nullptr),
+	m_proxyRight(nullptr),
 	m_count(0)
 {}
 
@@ -64,32 +67,58 @@ ScreenManager::~ScreenManager()
 }
 
 Screen* ScreenManager::add()
+{
+	Screen* newScreen = create();
+
+	// new screens go to the end of this server's part of the wall
+	insertBefore(newScreen, m_proxyRight);
+
+	return newScreen;
+}
+
+Screen* ScreenManager::addProxy(Cross side)
+{
+	Screen* newScreen = create();
+
+	switch (side)
+	{
+	case CROSS_LEFT:
+		insertBefore(newScreen, m_first);
+		m_proxyLeft = newScreen;
+		break;
+
+	case CROSS_RIGHT:
+		insertBefore(newScreen, nullptr);
+		m_proxyRight = newScreen;
+		break;
+	}
+
+	return newScreen;
+}
+
+Screen* ScreenManager::create()
 {
 	Screen* newScreen = new Screen();
 	newScreen->prev = nullptr;
 	newScreen->next = nullptr;
 	newScreen->owner = nullptr;
+	newScreen->boundaryLeft = newScreen->boundaryRight = 0.f;
 
-	if (m_count == 0)
-	{
-		m_first = newScreen;
-		m_last = newScreen;
-	}
-	else
-	{
-		Screen* curr = m_first;
+	return newScreen;
+}
 
-		while (curr->next) curr = curr->next;
+void ScreenManager::insertBefore(Screen* newScreen, Screen* before)
+{
+	newScreen->next = before;
+	newScreen->prev = before ? before->prev : m_last;
 
-		curr->next = newScreen;
-		newScreen->prev = curr;
+	if (newScreen->prev) newScreen->prev->next = newScreen;
+	else m_first = newScreen;
 
-		m_last = newScreen;
-	}
+	if (newScreen->next) newScreen->next->prev = newScreen;
+	else m_last = newScreen;
 
 	++m_count;
-
-	return newScreen;
 }
 
 Screen* ScreenManager::getFirst()
@@ -102,6 +131,16 @@ Screen* ScreenManager::getLast()
 	return m_last;
 }
 
+Screen* ScreenManager::getProxy(Cross side) const
+{
+	switch (side)
+	{
+	case CROSS_LEFT: return m_proxyLeft;
+	case CROSS_RIGHT: return m_proxyRight;
+	default: return nullptr;
+	}
+}
+
 Screen* ScreenManager::get(EntityID ownerID)
 {
 	Screen* curr = m_first;
@@ -132,6 +171,11 @@ bool ScreenManager::rem(EntityID ownerID)
 	if (toRemove == m_last)
 		m_last = toRemove->prev;
 
+	if (toRemove == m_proxyLeft)
+		m_proxyLeft = nullptr;
+	if (toRemove == m_proxyRight)
+		m_proxyRight = nullptr;
+
 	delete toRemove; toRemove = nullptr;
 
 	--m_count;
@@ -164,6 +208,8 @@ void ScreenManager::clear()
 
 	m_first = nullptr;
 	m_last = nullptr;
+	m_proxyLeft = nullptr;
+	m_proxyRight = nullptr;
 	m_count = 0;
 }
 
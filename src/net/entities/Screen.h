@@ -25,17 +25,25 @@ public:
 	~ScreenManager();
 
 	Screen* add();
+	Screen* addProxy(Cross side);
 	Screen* getFirst();
 	Screen* getLast();
 	Screen* get(EntityID ownerID);
+	Screen* getProxy(Cross side) const;
 	bool rem(EntityID ownerID);
 	size_t count() const;
 	void clear();
 	void print() const;
 
 private:
+	Screen* create();
+	void insertBefore(Screen* newScreen, Screen* before);
+
 	Screen* m_first;
 	Screen* m_last;
+	// Stand-ins for the neighbouring servers' screens at either end of the chain
+	Screen* m_proxyLeft;
+	Screen* m_proxyRight;
 	size_t m_count;
 };
 
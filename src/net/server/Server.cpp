@@ -3,7 +3,23 @@
  *
  * @date       April 18, 2015
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Dropped clients are detached for a grace period so that they can resume their session.
+ *
+ *             October 18, 2026
+ *             Client sockets are spread across worker shards, this thread only accepts and expires sessions.
+ *
+ *             October 18, 2026
+ *             Hosts several independent walls (rooms), each one locked on its own.
+ *
+ *             October 18, 2026
+ *             A wall can span several servers linked to each other at the ends of their parts of the wall.
+ *
+ *             October 18, 2026
+ *             Stopping drains the outboxes and can be waited on instead of polling isRunning().
+ *
+ *             October 18, 2026
+ *             Only the configured peers can link on the peer port.
  *
  * @designer   Melvin Loho
  *
@@ -14,27 +30,61 @@
  */
 
 #include "Server.h"
+#include "ServerShard.h"
 #include "../Shared.h"
+#include "../PacketCreator.h"
 
+#include <algorithm>
 #include <iostream>
-#include <iomanip>
+
+const sf::Time Server::DEFAULT_SESSION_GRACE_PERIOD = sf::seconds(30.f);
+const unsigned int Server::DEFAULT_SHARD_COUNT = 4;
 
 void Server::Send(const Packet& p, Client* c)
 {
+	// nobody is listening on the other end of a detached client
+	if (!c->shard) return;
+
+	// whatever is meant for a proxy screen gets relayed to the owner of the peer's screen
+	if (c->peer)
+	{
+		SendToPeer(PacketCreator::Create().P_Relay(p), c);
+		return;
+	}
+
+	std::string toSend;
+	p.encode(toSend);
+
+	c->outboxMutex.lock();
+	c->outbox.push_back(toSend);
+	c->outboxMutex.unlock();
+
+	// the owning shard sends it out, it only needs a nudge if it is not the one calling
+	if (c->shard != ServerShard::Current()) c->shard->wake();
+}
+
+void Server::SendToPeer(const Packet& p, Client* peer)
+{
+	if (!peer->shard) return;
+
 	std::string toSend;
-	size_t length = p.encode(toSend);
+	p.encode(toSend);
 
-	c->socket.send(toSend.c_str(), length);
+	// the shard sends everything that piled up for a peer in one go
+	peer->outboxMutex.lock();
+	peer->outbox.push_back(toSend);
+	peer->outboxMutex.unlock();
 
-	std::cout << "SENT c=" << c->id << ", " << std::setfill('0') << std::setw(4) << length << " bytes>" << toSend << std::endl;
+	if (peer->shard != ServerShard::Current()) peer->shard->wake();
 }
 
 Server::Server() :
-	clients(new ClientManager()),
+	peerPort(0),
 	serverThread(&Server::receiveThread, this),
 	callbackOnConnect(nullptr),
 	callbackOnReceive(nullptr),
 	callbackOnDisconnect(nullptr),
+	sessionGracePeriod(DEFAULT_SESSION_GRACE_PERIOD),
 	is_running(false),
 	thread_running(false)
 {}
@@ -42,7 +92,7 @@ Server::Server() :
 Server::~Server()
 {
 	stop();
-	delete clients;
+	wait();
 }
 
 void Server::setConnectHandler(std::function<void(Client*)> onConnect)
@@ -60,12 +110,43 @@ void Server::setDisconnectHandler(std::function<void(Client*)> onDisconnect)
 	callbackOnDisconnect = onDisconnect;
 }
 
-bool Server::start(unsigned short port)
+void Server::setSessionGracePeriod(sf::Time gracePeriod)
+{
+	sessionGracePeriod = gracePeriod;
+}
+
+void Server::setPeerPort(unsigned short port)
+{
+	peerPort = port;
+}
+
+void Server::allowPeer(const sf::IpAddress& address)
+{
+	allowedPeers.insert(address);
+}
+
+bool Server::start(unsigned short port, unsigned int shardCount)
 {
 	if (isRunning()) return false;
 
 	if (listener.listen(port) != sf::Socket::Done) return false;
 	selector.add(listener);
+
+	if (peerPort)
+	{
+		if (peerListener.listen(peerPort) != sf::Socket::Done) return false;
+		selector.add(peerListener);
+	}
+
+	is_running = true;
+	thread_running = true;
+
+	for (unsigned int i = 0; i < std::max(shardCount, 1u); ++i)
+	{
+		shards.push_back(new ServerShard(*this, i));
+		shards.back()->start();
+	}
+
 	serverThread.launch();
 
 	return true;
@@ -73,14 +154,33 @@ bool Server::start(unsigned short port)
 
 void Server::stop()
 {
+	std::lock_guard<std::mutex> lock(mutexLifecycle);
+
 	is_running = false;
 
-	listener.close();
+	// the receive thread shuts everything down on its way out
+	if (!thread_running) shutdown();
+}
 
-	if (thread_running) return;
+void Server::wait()
+{
+	std::unique_lock<std::mutex> lock(mutexLifecycle);
+
+	stopped.wait(lock, [this] { return !thread_running; });
+}
+
+void Server::shutdown()
+{
+	listener.close();
+	peerListener.close();
 
 	selector.clear();
-	clients->clear();
+
+	for (ServerShard* shard : shards) delete shard;
+	shards.clear();
+
+	for (std::map<WallID, ClientManager*>::value_type& room : rooms) delete room.second;
+	rooms.clear();
 }
 
 bool Server::isRunning()
@@ -90,70 +190,186 @@ bool Server::isRunning()
 
 void Server::receiveThread()
 {
-	is_running = true;
-	thread_running = true;
-
 	while (is_running)
 	{
-		if (selector.wait())
+		// wake up every now and then to expire the detached sessions
+		if (selector.wait(sf::seconds(1.f)))
 		{
-			if (selector.isReady(listener)) // new connections
+			if (selector.isReady(listener)) accept(listener, false); // new clients
+			if (peerPort && selector.isReady(peerListener)) accept(peerListener, true); // new peers
+		}
+
+		expireSessions();
+	}
+
+	// stop receiving everywhere first, then send out whatever is still queued up
+	for (ServerShard* shard : shards) shard->stop();
+	for (ServerShard* shard : shards) shard->drain();
+
+	std::cout << "Server receive thread stopped!" << std::endl;
+
+	std::lock_guard<std::mutex> lock(mutexLifecycle);
+
+	shutdown();
+	thread_running = false;
+
+	stopped.notify_all();
+}
+
+void Server::expireSessions()
+{
+	std::lock_guard<std::mutex> lockRooms(mutexRooms);
+
+	for (std::map<WallID, ClientManager*>::iterator room = rooms.begin(); room != rooms.end();)
+	{
+		std::unique_lock<std::mutex> lock(room->second->getMutex());
+
+		ClientManager::SessionList& detached = room->second->getDetachedList();
+
+		for (ClientManager::SessionListIter it = detached.begin(); it != detached.end();)
+		{
+			if (it->second->sessionClock.getElapsedTime() > sessionGracePeriod)
 			{
-				Client* newClient = clients->add();
-
-				if (listener.accept(newClient->socket) == sf::Socket::Done)
-				{
-					selector.add(newClient->socket);
-
-					callbackOnConnect(newClient);
-				}
-				else
-				{
-					clients->rem(newClient);
-				}
+				callbackOnDisconnect(it->second);
+
+				it = room->second->remDetached(it);
 			}
-			else // other events (data receive / client disconnects)
+			else
 			{
-				ClientManager::ListIter it = clients->getList().begin(); Client* c;
-
-				while (it != clients->getList().end())
-				{
-					c = *it;
-
-					if (selector.isReady(c->socket))
-					{
-						char buffer[Packet::MAX_SIZE]; Packet p;
-
-						size_t received;
-						if (c->socket.receive(buffer, Packet::MAX_SIZE, received) == sf::Socket::Done)
-						{
-							std::cout << "RECV c=" << c->id << ", " << std::setfill('0') << std::setw(4) << received << " bytes>";
-
-							p.decode(buffer, received);
-							callbackOnReceive(p, c);
-
-							++it;
-						}
-						else
-						{
-							callbackOnDisconnect(c);
-
-							selector.remove(c->socket);
-							it = clients->rem(it);
-						}
-					}
-					else
-					{
-						++it;
-					}
-				}
+				++it;
 			}
 		}
+
+		// close walls that nobody is on anymore
+		if (room->second->isEmpty())
+		{
+			std::cout << "Wall " << room->first << " closed!" << std::endl;
+
+			lock.unlock();
+			delete room->second;
+			room = rooms.erase(room);
+		}
+		else
+		{
+			++room;
+		}
 	}
+}
 
-	std::cout << "Server receive thread stopped!" << std::endl;
+bool Server::join(Client* c, WallID wallID)
+{
+	std::lock_guard<std::mutex> lockRooms(mutexRooms);
 
-	thread_running = false;
+	ClientManager*& room = rooms[wallID];
 
-	stop();
+	if (!room)
+	{
+		std::cout << "Wall " << wallID << " opened!" << std::endl;
+
+		room = new ClientManager(wallID);
+	}
+
+	std::lock_guard<std::mutex> lock(room->getMutex());
+
+	// only one peer per end of the wall
+	if (c->peer && (c->peer->side == CROSS_NONE || room->getScreenManager().getProxy(c->peer->side))) return false;
+
+	room->add(c);
+
+	return true;
+}
+
+void Server::accept(sf::TcpListener& from, bool isPeer)
+{
+	Client* newClient = ClientManager::Create();
+
+	if (isPeer)
+	{
+		// the side is only known once the peer introduces itself
+		newClient->peer = new Peer();
+		newClient->peer->side = CROSS_NONE;
+	}
+
+	if (from.accept(newClient->socket) == sf::Socket::Done)
+	{
+		// anybody can reach the peer port, only the servers we know of get to link
+		if (isPeer && allowedPeers.find(newClient->socket.getRemoteAddress()) == allowedPeers.end())
+		{
+			std::cout << "Refused a peer link from " << newClient->socket.getRemoteAddress() << std::endl;
+
+			newClient->socket.disconnect();
+			delete newClient->peer;
+			delete newClient;
+			return;
+		}
+
+		// the client only gets a wall (and a screen in it) with its P_INIT (or P_PEER)
+		pickShard(newClient)->adopt(newClient);
+
+		callbackOnConnect(newClient);
+	}
+	else
+	{
+		delete newClient->peer;
+		delete newClient;
+	}
+}
+
+bool Server::federate(WallID wallID, Cross side, const std::string& peerIP, unsigned short peerPort)
+{
+	if (!is_running || side == CROSS_NONE) return false;
+
+	Client* link = ClientManager::Create();
+
+	link->peer = new Peer();
+	link->peer->side = side;
+
+	if (link->socket.connect(peerIP, peerPort) != sf::Socket::Done || !join(link, wallID))
+	{
+		delete link->peer;
+		delete link;
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(link->room->getMutex());
+
+	pickShard(link)->adopt(link);
+
+	// introduce ourselves from the peer's point of view
+	SendToPeer(PacketCreator::Create().P_Peer(wallID, side == CROSS_LEFT ? CROSS_RIGHT : CROSS_LEFT), link);
+
+	callbackOnConnect(link);
+
+	return true;
+}
+
+ServerShard* Server::pickShard(const Client* c) const
+{
+	size_t total = 0;
+
+	for (ServerShard* shard : shards) total += shard->getClientCount();
+
+	// fill the shards up evenly
+	size_t capacity = (total + shards.size()) / shards.size();
+
+	// stay next to the left neighbour so that every shard holds a contiguous part of the wall
+	Screen* neighbour = c->screenOwned ? c->screenOwned->prev : nullptr;
+	ServerShard* candidate = (neighbour && neighbour->owner->shard) ? neighbour->owner->shard : nullptr;
+
+	if (candidate && candidate->getClientCount() >= capacity)
+	{
+		candidate = candidate->getIndex() + 1 < shards.size() ? shards[candidate->getIndex() + 1] : nullptr;
+	}
+
+	if (candidate && candidate->getClientCount() < capacity) return candidate;
+
+	// otherwise fall back to the least loaded shard
+	candidate = shards.front();
+
+	for (ServerShard* shard : shards)
+	{
+		if (shard->getClientCount() < candidate->getClientCount()) candidate = shard;
+	}
+
+	return candidate;
 }
@@ -1,7 +1,13 @@
 #ifndef SERVER_H
 #define SERVER_H
 
+#include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
 #include <SFML/Network.hpp>
 #include <SFML/System.hpp>
 #include "../Packet.h"
@@ -9,11 +15,18 @@
 
 struct Client;
 class ClientManager;
+class ServerShard;
 
 class Server
 {
+	friend class ServerShard;
+
 public:
+	static const sf::Time DEFAULT_SESSION_GRACE_PERIOD;
+	static const unsigned int DEFAULT_SHARD_COUNT;
+
 	static void Send(const Packet& p, Client* c);
+	static void SendToPeer(const Packet& p, Client* peer);
 
 	Server();
 	~Server();
@@ -21,27 +34,47 @@ public:
 	void setConnectHandler(std::function<void(Client*)> onConnect);
 	void setReceiveHandler(std::function<void(const Packet&, Client*)> onReceive);
 	void setDisconnectHandler(std::function<void(Client*)> onDisconnect);
+	void setSessionGracePeriod(sf::Time gracePeriod);
+	void setPeerPort(unsigned short port);
+	// Only the servers allowed before starting can link on the peer port
+	void allowPeer(const sf::IpAddress& address);
 
-	bool start(unsigned short port);
+	bool start(unsigned short port, unsigned int shardCount = DEFAULT_SHARD_COUNT);
 	void stop();
 
-	inline ClientManager& getClientManager() { return *clients; }
-	inline ClientManager::List& getClients() { return clients->getList(); }
+	bool federate(WallID wallID, Cross side, const std::string& peerIP, unsigned short peerPort);
 
 	bool isRunning();
+	void wait();
 
 private:
 	void receiveThread();
+	void shutdown();
+	void expireSessions();
+	bool join(Client* c, WallID wallID);
+	void accept(sf::TcpListener& from, bool isPeer);
+	ServerShard* pickShard(const Client* c) const;
 
 	sf::TcpListener listener;
+	// Accepts the links of the servers hosting the neighbouring parts of a wall
+	sf::TcpListener peerListener;
+	unsigned short peerPort;
+	std::set<sf::IpAddress> allowedPeers;
 	sf::SocketSelector selector;
-	ClientManager* clients;
 	sf::Thread serverThread;
+	std::vector<ServerShard*> shards;
+	// Every wall hosted by this server, each one with its own clients, screens and lock
+	std::map<WallID, ClientManager*> rooms;
+	std::mutex mutexRooms;
 	std::function<void(Client*)> callbackOnConnect;
 	std::function<void(const Packet&, Client*)> callbackOnReceive;
 	std::function<void(Client*)> callbackOnDisconnect;
+	sf::Time sessionGracePeriod;
 
-	bool is_running, thread_running;
+	std::atomic<bool> is_running, thread_running;
+	// Signalled once the server has completely stopped
+	std::condition_variable stopped;
+	std::mutex mutexLifecycle;
 };
 
 #endif // SERVER_H
@@ -0,0 +1,323 @@
+/**
+ * A worker of the server.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions  October 18, 2026
+ *             Also carries the links to neighbouring servers, which exchange batches of packets.
+ *
+ *             October 18, 2026
+ *             Outboxes are drained once every shard has stopped.
+ *
+ *             October 18, 2026
+ *             The packets of a peer's batches are length-prefixed instead of separated.
+ *
+ *             October 18, 2026
+ *             Every client's packets are length-prefixed too, several of them can come out of a single receive.
+ *
+ *             October 18, 2026
+ *             Dropped clients are taken off the list of clients moving to another shard.
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @notes      Each shard owns the sockets of a contiguous range of screens in a wall.
+ *             It receives and decodes their packets, runs the game logic under the lock of the client's wall
+ *             and sends out whatever got queued up in its clients' outboxes.
+ *
+ *             Packets addressed to a client of another shard are queued in that client's outbox
+ *             and its shard gets woken up through its loopback socket.
+ */
+
+#include "ServerShard.h"
+
+#include "Server.h"
+#include "../Packet.h"
+#include "../entities/Client.h"
+#include "../entities/Screen.h"
+
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+static thread_local ServerShard* CURRENT_SHARD = nullptr;
+
+ServerShard* ServerShard::Current()
+{
+	return CURRENT_SHARD;
+}
+
+ServerShard::ServerShard(Server& server, unsigned int index) :
+	server(server),
+	index(index),
+	thread(&ServerShard::workerThread, this),
+	wakePending(false),
+	clientCount(0)
+{
+	waker.bind(sf::Socket::AnyPort, sf::IpAddress::LocalHost);
+	waker.setBlocking(false);
+	selector.add(waker);
+}
+
+ServerShard::~ServerShard()
+{
+	stop();
+}
+
+void ServerShard::start()
+{
+	thread.launch();
+}
+
+void ServerShard::stop()
+{
+	wake();
+	thread.wait();
+}
+
+void ServerShard::adopt(Client* c)
+{
+	c->shard = this;
+	++clientCount;
+
+	mutexPending.lock();
+	pending.push_back(c);
+	mutexPending.unlock();
+
+	wake();
+}
+
+void ServerShard::wake()
+{
+	if (wakePending.exchange(true)) return;
+
+	char signal = 0;
+	waker.send(&signal, sizeof(signal), sf::IpAddress::LocalHost, waker.getLocalPort());
+}
+
+void ServerShard::workerThread()
+{
+	CURRENT_SHARD = this;
+
+	while (server.is_running)
+	{
+		if (selector.wait(sf::seconds(1.f)))
+		{
+			if (selector.isReady(waker))
+			{
+				char signal; size_t received; sf::IpAddress sender; unsigned short port;
+
+				wakePending = false;
+				while (waker.receive(&signal, sizeof(signal), received, sender, port) == sf::Socket::Done);
+			}
+
+			List::iterator it = clients.begin(); Client* c;
+
+			while (it != clients.end())
+			{
+				c = *it;
+
+				if (selector.isReady(c->socket))
+				{
+					char buffer[Packet::MAX_SIZE]; Packet p;
+
+					size_t received;
+					bool connected = c->socket.receive(buffer, Packet::MAX_SIZE, received) == sf::Socket::Done;
+
+					if (connected)
+					{
+						// every packet is preceded by its length, a receive can hold several of them (or part of one)
+						std::string& stream = c->stream;
+						size_t length;
+
+						stream.append(buffer, received);
+
+						while (connected && Packet::PeekRecordLength(stream, length))
+						{
+							if (length > Packet::MAX_RECORD_SIZE)
+							{
+								std::cout << (c->peer ? "Peer " : "Client ") << c->id << " sent a corrupt record, dropping the link" << std::endl;
+								connected = false;
+								break;
+							}
+
+							if (stream.length() < Packet::RECORD_HEADER_SIZE + length) break;
+
+							std::cout << (c->peer ? "RECV peer=" : "RECV c=") << c->id << ", " << std::setfill('0') << std::setw(4) << length << " bytes>";
+
+							// decoding does not touch the shared state
+							p.decode(stream.c_str() + Packet::RECORD_HEADER_SIZE, length);
+							stream.erase(0, Packet::RECORD_HEADER_SIZE + length);
+
+							connected = receive(c, p);
+						}
+					}
+
+					if (connected) ++it;
+					else drop(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+		}
+
+		migrate();
+		adoptPending();
+		flush();
+	}
+
+	CURRENT_SHARD = nullptr;
+}
+
+void ServerShard::drain()
+{
+	// every shard has stopped by now, so nothing else can be queued up anymore
+	adoptPending();
+	flush();
+
+	// hand the sockets back, the server clears the walls once every shard is drained
+	for (Client* c : clients)
+	{
+		selector.remove(c->socket);
+
+		// clients that never got onto a wall only belong to their shard
+		if (!c->room)
+		{
+			delete c->peer;
+			delete c;
+		}
+	}
+	clients.clear();
+}
+
+void ServerShard::adoptPending()
+{
+	std::lock_guard<std::mutex> lock(mutexPending);
+
+	for (Client* c : pending)
+	{
+		selector.add(c->socket);
+		clients.push_back(c);
+	}
+
+	pending.clear();
+}
+
+bool ServerShard::receive(Client* c, const Packet& p)
+{
+	bool joining = !c->room;
+
+	if (joining)
+	{
+		// only a P_INIT (or a P_PEER from a peer) can bring a client onto a wall
+		if (!c->peer && p.type == P_INIT)
+		{
+			server.join(c, p.getDataSize() > 6 ? p.get<WallID>(6) : 0);
+		}
+		else if (c->peer && p.type == P_PEER)
+		{
+			c->peer->side = static_cast<Cross>(p.get<int>(1));
+
+			if (!server.join(c, p.get<WallID>(0))) return false;
+		}
+		else
+		{
+			return true;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(c->room->getMutex());
+
+	server.callbackOnReceive(p, c);
+
+	// move next to the rest of its part of the wall
+	if (joining) leaving.push_back(c);
+
+	return true;
+}
+
+void ServerShard::migrate()
+{
+	for (Client* c : leaving)
+	{
+		std::lock_guard<std::mutex> lock(c->room->getMutex());
+
+		ServerShard* home = server.pickShard(c);
+
+		if (home == this) continue;
+
+		selector.remove(c->socket);
+		clients.erase(std::find(clients.begin(), clients.end(), c));
+		--clientCount;
+
+		home->adopt(c);
+	}
+
+	leaving.clear();
+}
+
+void ServerShard::drop(List::iterator& it)
+{
+	Client* c = *it;
+
+	selector.remove(c->socket);
+	it = clients.erase(it);
+	--clientCount;
+
+	// a client dropped right after joining (e.g. a peer whose batch goes bad after its P_PEER) has nowhere to move to
+	leaving.erase(std::remove(leaving.begin(), leaving.end(), c), leaving.end());
+
+	if (!c->room)
+	{
+		delete c->peer;
+		delete c;
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(c->room->getMutex());
+
+	// a lost peer takes its proxy screen along, there is no session to resume
+	if (c->peer)
+	{
+		server.callbackOnDisconnect(c);
+
+		c->room->rem(c);
+		return;
+	}
+
+	std::cout << "Client " << c->id << " detached, session kept for " << server.sessionGracePeriod.asSeconds() << "s" << std::endl;
+
+	c->room->detach(c);
+}
+
+void ServerShard::flush()
+{
+	std::deque<std::string> toSend;
+
+	for (Client* c : clients)
+	{
+		c->outboxMutex.lock();
+		toSend.swap(c->outbox);
+		c->outboxMutex.unlock();
+
+		if (!toSend.empty())
+		{
+			// batch everything into a single send, each packet preceded by its length
+			std::string batch;
+
+			for (const std::string& data : toSend)
+			{
+				Packet::AppendRecord(batch, data);
+			}
+
+			c->socket.send(batch.c_str(), batch.length());
+
+			std::cout << (c->peer ? "SENT peer=" : "SENT c=") << c->id << ", " << toSend.size() << " packets, " << std::setfill('0') << std::setw(4) << batch.length() << " bytes" << std::endl;
+		}
+
+		toSend.clear();
+	}
+}
@@ -0,0 +1,61 @@
+#ifndef SERVERSHARD_H
+#define SERVERSHARD_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <SFML/Network.hpp>
+#include <SFML/System.hpp>
+
+struct Client;
+struct Packet;
+class Server;
+
+class ServerShard
+{
+public:
+	typedef std::vector<Client*> List;
+
+	// The shard running on the calling thread (null outside of the shard threads)
+	static ServerShard* Current();
+
+	ServerShard(Server& server, unsigned int index);
+	~ServerShard();
+
+	void start();
+	void stop();
+	void drain();
+
+	void adopt(Client* c);
+	void wake();
+
+	inline unsigned int getIndex() const { return index; }
+	inline size_t getClientCount() const { return clientCount; }
+
+private:
+	void workerThread();
+	void adoptPending();
+	bool receive(Client* c, const Packet& p);
+	void migrate();
+	void drop(List::iterator& it);
+	void flush();
+
+	Server& server;
+	const unsigned int index;
+
+	sf::Thread thread;
+	sf::SocketSelector selector;
+	// Loopback socket used to wake the selector up when there is something to send
+	sf::UdpSocket waker;
+	std::atomic<bool> wakePending;
+
+	List clients;
+	List pending;
+	std::mutex mutexPending;
+	// Clients that just joined a wall, to be moved to the shard holding their part of it
+	List leaving;
+
+	std::atomic<size_t> clientCount;
+};
+
+#endif // SERVERSHARD_H
@@ -3,7 +3,50 @@
  *
  * @date       March 9, 2015
  *
- * @revisions
+ * @revisions  October 18, 2026
+ *             Reconnecting resumes the previous session when the server still holds it.
+ *
+ *             October 18, 2026
+ *             Random particle colours come from the scene's own random stream instead of rand().
+ *
+ *             October 18, 2026
+ *             The particle systems are updated in parallel on the window's job system.
+ *
+ *             October 18, 2026
+ *             The particle systems share a budget that follows the frame time.
+ *
+ *             October 18, 2026
+ *             Players are prewarmed and pooled so that crossings don't stall the game.
+ *
+ *             October 18, 2026
+ *             The music comes from the resource cache.
+ *
+ *             October 18, 2026
+ *             The renderer holds enough vertices for all of the prewarmed players' particles to be drawn at once.
+ *
+ *             October 18, 2026
+ *             Shows what sorting the draws saves in draw calls and state changes.
+ *
+ *             October 18, 2026
+ *             The particles out of view are culled before they get built.
+ *
+ *             October 18, 2026
+ *             The players' transforms are brought up to date after the update, not while drawing.
+ *
+ *             October 18, 2026
+ *             The players' particle systems are updated and drawn through their shared scene graph.
+ *
+ *             October 18, 2026
+ *             A frame is recorded into the renderer and presented, the window may draw it on its render thread.
+ *
+ *             October 18, 2026
+ *             The log is laid out once, only the values that changed get laid out again.
+ *
+ *             October 18, 2026
+ *             The network and particle updates are profiled, F3 shows the profiler's overlay.
+ *
+ *             October 18, 2026
+ *             The labels' glyphs are prepared when the scene is created.
  *
  * @designer   Melvin Loho
  *
@@ -15,22 +58,44 @@
 #include "GameScene.h"
 
 #include "../GameSettings.h"
+#include "../core/Profiler.h"
+#include "../core/ResourceCache.h"
+#include "../core/object/Glyph.h"
 #include "../engine/AppWindow.h"
 #include "../net/PacketCreator.h"
 #include "../net/entities/Client.h"
 #include "../net/entities/Screen.h"
 #include "../effect/impl/Fireball.h"
 
+#include <cmath>
 #include <iostream>
 
 using namespace std;
 
+// Players ready to cross onto the screen without having to build their particle systems
+static const unsigned int PREWARMED_PLAYERS = 8;
+
+// The share of the particle budget of my own player compared to one right in the middle of the view
+static const float OWN_PARTICLE_PRIORITY = 4.f;
+
+// The fields of the log for each player: name, x, y, level of detail and cap, each after its label
+static const unsigned int LOG_PLAYER_FIELDS = 11;
+
+// Enough for the particles of every prewarmed player to go out in a single draw call
+static const unsigned int RENDERER_VERTICES = PREWARMED_PLAYERS * 5000 * SPRITE_VERTICES;
+
 GameScene::GameScene(AppWindow &window) : Scene(window, "Game Scene")
-, renderer(window, 1000)
+, renderer(window, RENDERER_VERTICES)
+, sessionToken(Client::NO_SESSION)
 , me(nullptr)
 , myScreen(new Screen())
+, isShowingProfiler(false)
+, profiler(*scene_font, LOG_CHARACTER_SIZE)
 {
-	bgm.openFromFile("Data/audio/gardenparty_mono.wav");
+	bgm = ResourceCache::GetMusic("Data/audio/gardenparty_mono.wav");
+
+	// the players' labels only ever use prepared glyphs, see Glyph.h
+	getWindow().runOnRenderThread([this] { PrepareGlyphs(*scene_font, Player::LABEL_CHARACTER_SIZE); });
 }
 
 GameScene::~GameScene()
@@ -45,11 +110,20 @@ void GameScene::onload()
 	view_hud = view_main = getWindow().getCurrentView();
 	updateViews();
 
+	// lay the log out
+	buildLog();
+
 	// uncontrol the particle
 	setControlParticle(isControllingParticle = false);
 
+	// the fireballs' shared texture and shader, set up where nothing can be drawing with them
+	getWindow().runOnRenderThread([] { Fireball::Prepare(); });
+
+	// build the players of the wall ahead of time, crossing onto this screen shouldn't stall the game
+	players.prewarm(Player::ParticleSystemType::FIREBALL, PREWARMED_PLAYERS);
+
 	// create my player
-	me = players.add(Client::MYSELF, sf::IpAddress::getLocalAddress().toString(), Player::ParticleSystemType::FIREBALL, *scene_log.text().getFont());
+	me = players.add(Client::MYSELF, sf::IpAddress::getLocalAddress().toString(), Player::ParticleSystemType::FIREBALL, *scene_font);
 
 	// center the player
 	sf::Vector2i center = sf::Vector2i(view_main.getCenter());
@@ -58,9 +132,9 @@ void GameScene::onload()
 
 	// music settings
 	sf::Listener::setPosition(center.x, center.y, -100);
-	bgm.setPosition(center.x, center.y, 0);
-	bgm.setMinDistance(1000);
-	bgm.setLoop(true);
+	bgm->setPosition(center.x, center.y, 0);
+	bgm->setMinDistance(1000);
+	bgm->setLoop(true);
 
 	// initialize connection
 	initConnection();
@@ -72,7 +146,7 @@ void GameScene::unload()
 
 	players.clear();
 
-	bgm.stop();
+	bgm->stop();
 
 	getWindow().setMouseCursorVisible(true);
 }
@@ -159,8 +233,11 @@ void GameScene::handleEvent(const sf::Event& event)
 			break;
 		case sf::Keyboard::M:
 			bgmToggle = !bgmToggle;
-			if (bgmToggle) bgm.play();
-			else bgm.stop();
+			if (bgmToggle) bgm->play();
+			else bgm->stop();
+			break;
+		case sf::Keyboard::F3:
+			isShowingProfiler = !isShowingProfiler;
 			break;
 		}
 		break;
@@ -173,75 +250,215 @@ void GameScene::handleEvent(const sf::Event& event)
 
 void GameScene::update(const sf::Time& deltaTime)
 {
-	ParticleSystem::TotalParticleCount = 0;
-
-	while (conn.pollEvent(connEvent))
 	{
-		handleConnectionEvent(connEvent);
+		Profiler::Scope network(Profiler::NETWORK);
+
+		while (conn.pollEvent(connEvent))
+		{
+			handleConnectionEvent(connEvent);
+		}
 	}
 
+	// share the particle budget, my own player first, then whoever is the closest to the middle of the view
+
+	const sf::Vector2f viewCenter = view_main.getCenter();
+	const float viewReach = std::max(view_main.getSize().x, view_main.getSize().y) * 0.5f;
+
+	budget.clear();
+
 	for (Player* player : players.getList())
 	{
-		player->ps->update(deltaTime);
+		const sf::Vector2f offset = player->ps->emitterPos - viewCenter;
+		const float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+
+		budget.add(player->ps, player == me ? OWN_PARTICLE_PRIORITY : 1.f / (1.f + distance / viewReach));
 	}
 
-	std::string log;
-
-	log =
-		getWindow().getName() + " by " + "Melvin Loho"
-		+ "\n"
-		+ "\n"
-		+ "[FPS]: " + std::to_string(getWindow().getFPS())
-		+ "\n"
-		+ "\n[RENDERER]"
-		+ "\n draw calls: " + std::to_string(renderer.getDrawCallCount())
-		+ "\n sprites   : " + std::to_string(renderer.getSpriteCount())
-		+ "\n"
-		+ "\n[SCREEN]"
-		"\n x: " + std::to_string(myScreen->size.x)
-		+ "\n y: " + std::to_string(myScreen->size.y)
-		+ "\n"
-		+ "\n[PARTICLES]: " + std::to_string(ParticleSystem::TotalParticleCount)
-		+ "\n";
+	budget.apply(getWindow().getFrameTime());
+
+	// every particle system is a job (large ones split up further), all of them are done before rendering
+
+	JobSystem& jobs = getWindow().getJobs();
+	JobSystem::Group systems;
+	unsigned int particleCount = 0;
+	const sf::FloatRect viewBounds = Renderer::GetViewBounds(view_main);
+
+	const std::vector<BGO*>& emitters = players.getRoot().getComponents(SceneGraph::EMITTER);
 
-	for (Player* player : players.getList())
 	{
-		log +=
-			"\n >" + player->label.text().getString()
-			+ "\n  x: " + std::to_string(player->ps->emitterPos.x)
-			+ "\n  y: " + std::to_string(player->ps->emitterPos.y)
-			+ "\n";
+		Profiler::Scope particles(Profiler::PARTICLES);
+
+		for (BGO* emitter : emitters)
+		{
+			ParticleSystem* ps = static_cast<ParticleSystem*>(emitter);
+
+			ps->setCullRect(viewBounds);
+
+			jobs.run(systems, [ps, deltaTime, &jobs] { ps->update(deltaTime, jobs); });
+		}
+
+		jobs.wait(systems);
 	}
 
-	scene_log.text().setString(log);
-}
+	for (BGO* emitter : emitters)
+	{
+		ParticleSystem* ps = static_cast<ParticleSystem*>(emitter);
 
-void GameScene::render()
-{
-	getWindow().clear();
+		// back on the main thread
+		ps->applyEmitter();
+
+		particleCount += ps->getParticleCount();
+	}
+
+	// the labels follow their emitters
+	players.getRoot().updateTransforms();
+
+	// only the values that changed get laid out again
+
+	scene_log.setValue(logFields.fps, getWindow().getFPS());
+
+	scene_log.setValue(logFields.drawCalls, renderer.getDrawCallCount());
+	scene_log.setValue(logFields.unsortedDrawCalls, renderer.getUnsortedDrawCallCount());
+	scene_log.setValue(logFields.stateChanges, renderer.getStateChangeCount());
+	scene_log.setValue(logFields.unsortedStateChanges, renderer.getUnsortedStateChangeCount());
+	scene_log.setValue(logFields.sprites, renderer.getSpriteCount());
+	scene_log.setValue(logFields.culled, renderer.getCulledCount());
 
-	renderer.resetStats();
+	scene_log.setValue(logFields.pipeline, getWindow().isRenderThreaded() ? "render thread" : "single thread");
+	scene_log.setValue(logFields.renderTime, getWindow().getRenderTime().asMilliseconds());
+	scene_log.setValue(logFields.waitTime, getWindow().getPresentWaitTime().asMilliseconds());
 
-	getWindow().setView(view_main); ///////////////////////////////////
+	scene_log.setValue(logFields.screenX, myScreen->size.x);
+	scene_log.setValue(logFields.screenY, myScreen->size.y);
 
-	renderer.begin();
+	scene_log.setValue(logFields.particles, particleCount);
+	scene_log.setValue(logFields.threads, jobs.getWorkerCount() + 1);
+	scene_log.setValue(logFields.budget, budget.getBudget());
+	scene_log.setValue(logFields.capacity, budget.getCapacity());
+	scene_log.setValue(logFields.frameTime, budget.getFrameTime().asMilliseconds());
+	scene_log.setValue(logFields.targetFrameTime, budget.getTargetFrameTime().asMilliseconds());
+
+	// the players' fields are only added or removed when the number of players changes
+
+	if (scene_log.getFieldCount() != logFields.players + players.getList().size() * LOG_PLAYER_FIELDS)
+	{
+		scene_log.removeFields(logFields.players);
+
+		for (size_t i = 0; i < players.getList().size(); ++i)
+		{
+			scene_log.add("\n >");
+			scene_log.add();
+			scene_log.add("\n  x: ");
+			scene_log.add();
+			scene_log.add("\n  y: ");
+			scene_log.add();
+			scene_log.add("\n  lod: ");
+			scene_log.add();
+			scene_log.add("% (cap ");
+			scene_log.add();
+			scene_log.add(")\n");
+		}
+	}
+
+	HGO::Field field = logFields.players;
 
 	for (Player* player : players.getList())
 	{
-		renderer.draw(player->ps);
+		const ParticleSystem::LOD& lod = player->ps->getLOD();
+
+		// read through the const text, getting the other one would invalidate the label's transform
+		const TGO& label = player->label;
+
+		scene_log.setValue(field + 1, label.text().getString());
+		scene_log.setValue(field + 3, player->ps->emitterPos.x);
+		scene_log.setValue(field + 5, player->ps->emitterPos.y);
+		scene_log.setValue(field + 7, static_cast<int>(lod.spawnScale * lod.lifeTimeScale * 100 + 0.5f));
+		scene_log.setValue(field + 9, lod.cap);
+
+		field += LOG_PLAYER_FIELDS;
+	}
+
+	// the profiler's overlay sticks to the top right corner
+
+	if (isShowingProfiler)
+	{
+		profiler.setTargetFrameTime(budget.getTargetFrameTime());
+		profiler.updateSG(deltaTime);
+
+		const sf::FloatRect bounds = profiler.getBounds();
+		profiler.setPosition(sf::Vector2f(view_hud.getSize().x - bounds.width - 8.f, 8.f));
 	}
+}
+
+void GameScene::buildLog()
+{
+	scene_log.removeFields(0);
+
+	scene_log.add(getWindow().getName() + " by " + "Melvin Loho" + "\n\n[FPS]: ");
+	logFields.fps = scene_log.add();
+
+	scene_log.add("\n\n[RENDERER]\n draw calls: ");
+	logFields.drawCalls = scene_log.add();
+	scene_log.add(" (unsorted ");
+	logFields.unsortedDrawCalls = scene_log.add();
+	scene_log.add(")\n states    : ");
+	logFields.stateChanges = scene_log.add();
+	scene_log.add(" (unsorted ");
+	logFields.unsortedStateChanges = scene_log.add();
+	scene_log.add(")\n sprites   : ");
+	logFields.sprites = scene_log.add();
+	scene_log.add("\n culled    : ");
+	logFields.culled = scene_log.add();
+
+	scene_log.add("\n\n[PIPELINE]: ");
+	logFields.pipeline = scene_log.add();
+	scene_log.add("\n render    : ");
+	logFields.renderTime = scene_log.add();
+	scene_log.add(" ms\n waited    : ");
+	logFields.waitTime = scene_log.add();
+	scene_log.add(" ms");
+
+	scene_log.add("\n\n[SCREEN]\n x: ");
+	logFields.screenX = scene_log.add();
+	scene_log.add("\n y: ");
+	logFields.screenY = scene_log.add();
+
+	scene_log.add("\n\n[PARTICLES]: ");
+	logFields.particles = scene_log.add();
+	scene_log.add("\n threads   : ");
+	logFields.threads = scene_log.add();
+	scene_log.add("\n budget    : ");
+	logFields.budget = scene_log.add();
+	scene_log.add(" / ");
+	logFields.capacity = scene_log.add();
+	scene_log.add("\n frame     : ");
+	logFields.frameTime = scene_log.add();
+	scene_log.add(" ms (target ");
+	logFields.targetFrameTime = scene_log.add();
+	scene_log.add(" ms)\n");
+
+	logFields.players = scene_log.getFieldCount();
+}
+
+void GameScene::render()
+{
+	renderer.clear();
+
+	renderer.begin(view_main); ////////////////////////////////////////
+
+	renderer.draw(&players.getRoot());
 
 	renderer.end();
 
-	getWindow().setView(view_hud); ////////////////////////////////////
+	renderer.begin(view_hud); /////////////////////////////////////////
 
-	renderer.begin();
+	renderer.draw(&scene_log);
 
-	renderer.draw(scene_log);
+	if (isShowingProfiler) renderer.draw(&profiler);
 
 	renderer.end();
 
-	getWindow().display();
+	getWindow().present(renderer);
 }
 
 Player* GameScene::getPlayer(EntityID id)
@@ -264,7 +481,7 @@ bool GameScene::initConnection()
 			return false;
 		}
 
-		conn.send(PacketCreator::Create().P_Init(me->extractClientParams(), myScreen));
+		conn.send(PacketCreator::Create().P_Init(me->extractClientParams(), myScreen, sessionToken, GameSettings::wallID));
 	}
 
 	return true;
@@ -288,8 +505,12 @@ void GameScene::randomizeParticleColors(Player* player)
 {
 	ParticleParams pp;
 
-	pp.colorBegin = sf::Color(rand() & 255, rand() & 255, rand() & 255);
-	pp.colorEnd = sf::Color(rand() & 255, rand() & 255, rand() & 255);
+	// the high bytes, the generator's lowest bits are its weakest
+	sf::Uint32 bits = random.next();
+	pp.colorBegin = sf::Color(bits >> 24, (bits >> 16) & 255, (bits >> 8) & 255);
+
+	bits = random.next();
+	pp.colorEnd = sf::Color(bits >> 24, (bits >> 16) & 255, (bits >> 8) & 255);
 
 	conn.send(PacketCreator::Create().P_ParticleParams(pp));
 }
@@ -325,6 +546,15 @@ void GameScene::onReceive(const Packet& receivedPacket)
 	{
 	case P_INIT:
 	{
+		// the visitors are dropped either way, a resumed session gets the current ones sent right after
+		for (PlayerManager::ListIter it = players.getList().begin(); it != players.getList().end();)
+		{
+			if (*it == me) ++it;
+			else it = players.rem(it);
+		}
+
+		sessionToken = receivedPacket.get<sf::Uint32>(5);
+
 		me->setName(receivedPacket.get(0));
 		me->ps->colorBegin = sf::Color(receivedPacket.get<sf::Uint32>(1));
 		me->ps->colorEnd = sf::Color(receivedPacket.get<sf::Uint32>(2));
@@ -335,7 +565,7 @@ void GameScene::onReceive(const Packet& receivedPacket)
 
 	case P_NEW:
 	{
-		Player* newPlayer = players.add(receivedPacket.get<EntityID>(0), receivedPacket.get(4), Player::ParticleSystemType::FIREBALL, *scene_log.text().getFont());
+		Player* newPlayer = players.add(receivedPacket.get<EntityID>(0), receivedPacket.get(4), Player::ParticleSystemType::FIREBALL, *scene_font);
 		if (newPlayer->id == Client::MYSELF) me = newPlayer;
 
 		switch (static_cast<Cross>(receivedPacket.get<int>(1)))
@@ -3,7 +3,10 @@
 
 #include <SFML/Audio.hpp>
 #include "../engine/Scene.h"
+#include "../core/ProfilerOverlay.h"
+#include "../core/Random.h"
 #include "../core/Renderer.h"
+#include "../effect/ParticleBudget.h"
 #include "../net/client/Connection.h"
 #include "../net/entities/Player.h"
 
@@ -33,18 +36,38 @@ public:
 	void onDisconnect();
 
 private:
+	// The fields of the log that change, the players' fields come last
+	struct LogFields
+	{
+		HGO::Field fps;
+		HGO::Field drawCalls, unsortedDrawCalls, stateChanges, unsortedStateChanges, sprites, culled;
+		HGO::Field pipeline, renderTime, waitTime;
+		HGO::Field screenX, screenY;
+		HGO::Field particles, threads, budget, capacity, frameTime, targetFrameTime;
+		HGO::Field players;
+	};
+
+	void buildLog();
+
+	LogFields logFields;
 	sf::View view_hud, view_main;
 	Renderer renderer;
 
 	Connection conn;
 	Connection::Event connEvent;
+	sf::Uint32 sessionToken;
 
 	bool isControllingParticle;
 	PlayerManager players;
+	ParticleBudget budget;
 	Player* me;
 	Screen* myScreen;
+	Random random;
+
+	bool isShowingProfiler;
+	ProfilerOverlay profiler;
 
-	sf::Music bgm;
+	std::shared_ptr<sf::Music> bgm;
 };
 
 #endif // GAMESCENE_H
@@ -0,0 +1,103 @@
+/**
+ * A peer link going bad in the middle of a batch.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @notes      Links to a server as a peer and sends a single batch: a valid P_PEER, which puts the link onto a wall,
+ *             followed by a record whose length is over Packet::MAX_RECORD_SIZE.
+ *             The server has to drop the link and carry on without touching the dropped client again,
+ *             built with AddressSanitizer so that any use of it after it got deleted fails the check.
+ */
+
+#include "../net/Packet.h"
+#include "../net/PacketCreator.h"
+#include "../net/server/Server.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+static const unsigned short PORT = 45017;
+static const unsigned short PEER_PORT = 45018;
+static const WallID WALL = 7;
+
+// Only the header of a record, for a length that no record can have
+static void AppendHeader(std::string& batch, size_t length)
+{
+	for (int shift = (Packet::RECORD_HEADER_SIZE - 1) * 8; shift >= 0; shift -= 8)
+	{
+		batch += static_cast<char>((length >> shift) & 0xFF);
+	}
+}
+
+int main()
+{
+	Server server;
+
+	server.setConnectHandler([](Client*) {});
+	server.setReceiveHandler([](const Packet&, Client*) {});
+	server.setDisconnectHandler([](Client*) {});
+	server.setPeerPort(PEER_PORT);
+	server.allowPeer(sf::IpAddress::LocalHost);
+
+	// a single shard, so that the join and the drop happen in the same pass over its clients
+	if (!server.start(PORT, 1))
+	{
+		std::cerr << "Peer records: could not start the server" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	sf::TcpSocket link;
+
+	if (link.connect(sf::IpAddress::LocalHost, PEER_PORT, sf::seconds(5.f)) != sf::Socket::Done)
+	{
+		std::cerr << "Peer records: could not link to the server" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::string record;
+	PacketCreator::Create().P_Peer(WALL, CROSS_LEFT).encode(record);
+
+	std::string batch;
+
+	Packet::AppendRecord(batch, record);
+	AppendHeader(batch, Packet::MAX_RECORD_SIZE + 1);
+
+	if (link.send(batch.c_str(), batch.length()) != sf::Socket::Done)
+	{
+		std::cerr << "Peer records: could not send the batch" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// the server hangs up on a corrupt link
+	sf::SocketSelector selector;
+	selector.add(link);
+
+	char buffer[Packet::MAX_SIZE];
+	std::size_t received;
+
+	if (!selector.wait(sf::seconds(5.f)) || link.receive(buffer, sizeof(buffer), received) != sf::Socket::Disconnected)
+	{
+		std::cerr << "Peer records: the link was not dropped" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (!server.isRunning())
+	{
+		std::cerr << "Peer records: the server stopped" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	server.stop();
+	server.wait();
+
+	std::cout << "Peer records: a corrupt record after a P_PEER dropped the link cleanly" << std::endl;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,132 @@
+/**
+ * Trajectory parity of the fireball's steering.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @notes      Runs the steering kernel next to the atan2/cos/sin one it replaced, on the same particles,
+ *             and fails if any live particle ends up further than the tolerance from where the old one would have it.
+ *             The emitter goes around in a loop and particles spawn on it every tick, like a fireball being moved around.
+ */
+
+#include "../effect/impl/FireballSteering.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const unsigned int TICKS = 600;
+static const unsigned int SPAWN_RATE = 10;
+static const float DELTA_TIME = 1.f / 60.f;
+static const float LIFETIME_MAX = 2.f;
+static const float TOLERANCE = 0.5f;
+
+struct Particles
+{
+	std::vector<float> posX, posY, vel, lifetime, angleOffset;
+
+	void spawn(float x, float y, float lifetimeValue, float velValue, float angleOffsetValue)
+	{
+		posX.push_back(x);
+		posY.push_back(y);
+		vel.push_back(velValue);
+		lifetime.push_back(lifetimeValue);
+		angleOffset.push_back(angleOffsetValue);
+	}
+
+	void remove(size_t p)
+	{
+		posX.erase(posX.begin() + p);
+		posY.erase(posY.begin() + p);
+		vel.erase(vel.begin() + p);
+		lifetime.erase(lifetime.begin() + p);
+		angleOffset.erase(angleOffset.begin() + p);
+	}
+};
+
+// The kernel as it was, dead particles and particles on the emitter skipped
+static void steerWithTrig(Particles &particles, float emitterX, float emitterY, float invLifeTimeMax)
+{
+	for (size_t p = 0; p < particles.posX.size(); ++p)
+	{
+		if (particles.lifetime[p] <= 0.f) continue;
+
+		const float dx = emitterX - particles.posX[p];
+		const float dy = emitterY - particles.posY[p];
+
+		if (dx == 0.f && dy == 0.f) continue;
+
+		const float ratio = particles.lifetime[p] * invLifeTimeMax;
+		const float theta = std::atan2(dy, dx) + particles.angleOffset[p] * ratio;
+
+		particles.vel[p] = particles.vel[p] * ratio + particles.vel[p] * 0.15f;
+		particles.posX[p] += particles.vel[p] * std::cos(theta);
+		particles.posY[p] += particles.vel[p] * std::sin(theta);
+	}
+}
+
+int main()
+{
+	std::mt19937 generator(18102026);
+	std::uniform_real_distribution<float> lifetimes(0.f, LIFETIME_MAX), vels(3.f, 30.f), angleOffsets(-1.f, 1.f);
+
+	Particles before, after;
+	const float invLifeTimeMax = 1.f / LIFETIME_MAX;
+	float worst = 0.f;
+	unsigned int compared = 0;
+
+	for (unsigned int tick = 0; tick < TICKS; ++tick)
+	{
+		const float t = tick * DELTA_TIME;
+		const float emitterX = 400.f + 250.f * std::cos(t * 1.3f);
+		const float emitterY = 300.f + 150.f * std::sin(t * 2.1f);
+
+		for (unsigned int s = 0; s < SPAWN_RATE; ++s)
+		{
+			const float lifetime = lifetimes(generator), vel = vels(generator), angleOffset = angleOffsets(generator);
+
+			before.spawn(emitterX, emitterY, lifetime, vel, angleOffset);
+			after.spawn(emitterX, emitterY, lifetime, vel, angleOffset);
+		}
+
+		for (size_t p = 0; p < before.lifetime.size(); ++p)
+		{
+			before.lifetime[p] -= DELTA_TIME;
+			after.lifetime[p] -= DELTA_TIME;
+		}
+
+		// the system removes the dead particles before steering the rest
+		for (size_t p = before.lifetime.size(); p-- > 0;)
+		{
+			if (before.lifetime[p] <= 0.f)
+			{
+				before.remove(p);
+				after.remove(p);
+			}
+		}
+
+		steerWithTrig(before, emitterX, emitterY, invLifeTimeMax);
+		steer(after.posX.data(), after.posY.data(), after.vel.data(), after.lifetime.data(), after.angleOffset.data(),
+			static_cast<unsigned int>(after.posX.size()), emitterX, emitterY, invLifeTimeMax);
+
+		for (size_t p = 0; p < before.posX.size(); ++p)
+		{
+			const float dx = after.posX[p] - before.posX[p];
+			const float dy = after.posY[p] - before.posY[p];
+
+			worst = std::max(worst, std::sqrt(dx * dx + dy * dy));
+			++compared;
+		}
+	}
+
+	std::cout << "Steering parity: " << compared << " positions over " << TICKS << " ticks, "
+		<< "worst drift " << worst << " px (tolerance " << TOLERANCE << " px)" << std::endl;
+
+	return worst <= TOLERANCE ? EXIT_SUCCESS : EXIT_FAILURE;
+}
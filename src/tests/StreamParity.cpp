@@ -0,0 +1,154 @@
+/**
+ * Streamed batches against batches drawn from memory.
+ *
+ * @date       October 18, 2026
+ *
+ * @revisions
+ *
+ * @designer   Melvin Loho
+ *
+ * @programmer Melvin Loho
+ *
+ * @notes      Draws the same frames through the renderer twice into an offscreen target, once streaming the batches
+ *             into its ring of vertex buffers and once drawing them from memory (the client-side arrays),
+ *             and fails if a single pixel differs. Meant to be run on a software rasterizer (e.g. llvmpipe),
+ *             where both are exact, see the check-gl target of the Makefile.
+ *             The frames mix blend modes, textures and transforms, and a range bigger than the renderer's buffers,
+ *             over enough frames for the ring to wrap around.
+ */
+
+#include "../core/Renderer.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const unsigned int WIDTH = 320;
+static const unsigned int HEIGHT = 240;
+static const unsigned int FRAMES = 8;
+static const unsigned int MAX_VERTICES = 600;
+
+struct Range
+{
+	std::vector<sf::Vertex> vertices;
+	sf::RenderStates states;
+};
+
+static sf::Vertex RandomVertex(std::mt19937& generator, const sf::Vector2f& texSize)
+{
+	std::uniform_real_distribution<float> x(0.f, WIDTH), y(0.f, HEIGHT), u(0.f, texSize.x), v(0.f, texSize.y);
+	std::uniform_int_distribution<int> channel(0, 255);
+
+	return sf::Vertex(sf::Vector2f(x(generator), y(generator)),
+		sf::Color(channel(generator), channel(generator), channel(generator), channel(generator)),
+		sf::Vector2f(u(generator), v(generator)));
+}
+
+static std::vector<Range> BuildFrame(std::mt19937& generator, const sf::Texture& texture)
+{
+	const sf::Vector2f texSize(static_cast<float>(texture.getSize().x), static_cast<float>(texture.getSize().y));
+	std::uniform_int_distribution<int> triangles(1, 60);
+	std::vector<Range> ranges;
+
+	for (unsigned int r = 0; r < 24; ++r)
+	{
+		Range range;
+
+		// one range bigger than the renderer's buffers, it goes out on its own
+		const unsigned int count = (r == 12 ? MAX_VERTICES / 3 + 20 : triangles(generator)) * 3;
+
+		for (unsigned int i = 0; i < count; ++i) range.vertices.push_back(RandomVertex(generator, texSize));
+
+		range.states.blendMode = r % 3 == 0 ? sf::BlendAlpha : sf::BlendAdd;
+		range.states.texture = r % 2 == 0 ? &texture : nullptr;
+		if (r % 5 == 0) range.states.transform.rotate(r * 7.f, WIDTH * 0.5f, HEIGHT * 0.5f);
+
+		ranges.push_back(range);
+	}
+
+	return ranges;
+}
+
+static void Render(sf::RenderTexture& target, bool streaming,
+	const std::vector<std::vector<Range>>& frames, std::vector<sf::Image>& images)
+{
+	Renderer renderer(target, MAX_VERTICES);
+
+	renderer.setStreaming(streaming);
+
+	for (const std::vector<Range>& frame : frames)
+	{
+		renderer.clear(sf::Color(20, 30, 40));
+		renderer.begin(target.getDefaultView());
+
+		for (const Range& range : frame)
+		{
+			renderer.draw(range.vertices.data(), range.vertices.size(), sf::PrimitiveType::Triangles, range.states);
+		}
+
+		renderer.end();
+		renderer.swapFrames(false);
+		renderer.drawFrame();
+
+		target.display();
+		images.push_back(target.getTexture().copyToImage());
+	}
+}
+
+int main()
+{
+	if (!sf::VertexBuffer::isAvailable())
+	{
+		std::cerr << "Stream parity: vertex buffers are not available, there is nothing to compare" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	sf::RenderTexture target;
+
+	if (!target.create(WIDTH, HEIGHT))
+	{
+		std::cerr << "Stream parity: could not create the render texture" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// a gradient, so that texture coordinates that went wrong show up
+	sf::Image pattern;
+	pattern.create(64, 64);
+
+	for (unsigned int y = 0; y < 64; ++y)
+	{
+		for (unsigned int x = 0; x < 64; ++x) pattern.setPixel(x, y, sf::Color(x * 4, y * 4, (x ^ y) * 4));
+	}
+
+	sf::Texture texture;
+	texture.loadFromImage(pattern);
+
+	std::mt19937 generator(18102026);
+	std::vector<std::vector<Range>> frames;
+
+	for (unsigned int f = 0; f < FRAMES; ++f) frames.push_back(BuildFrame(generator, texture));
+
+	std::vector<sf::Image> streamed, fromMemory;
+
+	Render(target, true, frames, streamed);
+	Render(target, false, frames, fromMemory);
+
+	unsigned int differing = 0;
+
+	for (unsigned int f = 0; f < FRAMES; ++f)
+	{
+		for (unsigned int y = 0; y < HEIGHT; ++y)
+		{
+			for (unsigned int x = 0; x < WIDTH; ++x)
+			{
+				if (streamed[f].getPixel(x, y) != fromMemory[f].getPixel(x, y)) ++differing;
+			}
+		}
+	}
+
+	std::cout << "Stream parity: " << FRAMES << " frames of " << WIDTH << "x" << HEIGHT << ", "
+		<< differing << " pixels differ" << std::endl;
+
+	return differing == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}